@@ -1,22 +1,185 @@
-#include <map>
+#include <vector>
+#include <array>
+#include <memory>
+#include <algorithm>
 #include <iostream>
 #include <limits>
+#include <string>
+#include <string_view>
+#include <cstdio>
+#include <cstdint>
+#include <charconv>
+
+
+// Output through a big buffer, one fwrite per kBufferSize bytes.
+class BufferedWriter {
+public:
+    explicit BufferedWriter(std::FILE* file): file(file), buffer(kBufferSize), used(0)
+    {}
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    ~BufferedWriter() {
+        flush();
+    }
+
+    void write(const void* data, size_t length) {
+        if(used + length > buffer.size()) {
+            flush();
+        }
+        if(length > buffer.size()) {
+            std::fwrite(data, 1, length, file);
+            return;
+        }
+        std::copy_n(static_cast<const char*>(data), length, buffer.data() + used);
+        used += length;
+    }
+
+    void writeChar(char c) {
+        if(used == buffer.size()) {
+            flush();
+        }
+        buffer[used++] = c;
+    }
+
+    template<typename Integer>
+    void writeNumber(Integer number) {
+        if(used + kMaxNumberLength > buffer.size()) {
+            flush();
+        }
+        used = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), number).ptr - buffer.data();
+    }
+
+    void flush() {
+        std::fwrite(buffer.data(), 1, used, file);
+        used = 0;
+    }
+
+private:
+    static const size_t kBufferSize = 1 << 16;
+    static const size_t kMaxNumberLength = 24;
+
+    std::FILE* file;
+    std::vector<char> buffer;
+    size_t used;
+};
 
 
 template<typename T>
 class SuffixTree {
 public:
+    struct Node;
+
+    // Letters of the text are chars, virtual terminators of generalized
+    // strings are numbers above any char.
+    using Letter = int;
+
+    // Children of a node sorted by the first letter of the edge. Most nodes
+    // have a few children, so binary search over a flat array is enough; for
+    // high fan-out nodes an index by letter is kept next to the array.
+    class Children {
+    public:
+        using Edge = std::pair<Letter, Node*>;
+
+        Node* find(Letter ch) const {
+            if(index && (ch <= kMaxChar)) {
+                auto it = (*index)[ch - kMinChar];
+                return (it == kNoEdge) ? nullptr : edges[it].second;
+            }
+            auto it = m_lowerBound(ch);
+            return ((it != edges.end()) && (it->first == ch)) ? it->second : nullptr;
+        }
+
+        void set(Letter ch, Node* node) {
+            auto it = m_lowerBound(ch);
+            if((it != edges.end()) && (it->first == ch)) {
+                it->second = node;
+                return;
+            }
+            size_t position = it - edges.begin();
+            edges.insert(it, Edge(ch, node));
+            if(index) {
+                m_shiftIndex(ch, position);
+            }
+            else if(edges.size() > kSmallSize) {
+                m_buildIndex();
+            }
+        }
+
+        size_t size() const {
+            return edges.size();
+        }
+
+        typename std::vector<Edge>::const_iterator begin() const {
+            return edges.begin();
+        }
+
+        typename std::vector<Edge>::const_iterator end() const {
+            return edges.end();
+        }
+
+    private:
+        static const size_t kSmallSize = 8;
+        static const Letter kMinChar = std::numeric_limits<char>::min();
+        static const Letter kMaxChar = std::numeric_limits<char>::max();
+        static const unsigned short kNoEdge = std::numeric_limits<unsigned short>::max();
+
+        std::vector<Edge> edges;
+        std::unique_ptr<std::array<unsigned short, 256>> index;
+
+        typename std::vector<Edge>::iterator m_lowerBound(Letter ch) {
+            return std::lower_bound(edges.begin(), edges.end(), ch,
+                                    [](const Edge& e, Letter c) { return e.first < c; });
+        }
+
+        typename std::vector<Edge>::const_iterator m_lowerBound(Letter ch) const {
+            return std::lower_bound(edges.begin(), edges.end(), ch,
+                                    [](const Edge& e, Letter c) { return e.first < c; });
+        }
+
+        void m_buildIndex() {
+            if(!index) {
+                index = std::make_unique<std::array<unsigned short, 256>>();
+            }
+            index->fill(kNoEdge);
+            for(size_t i = 0; i < edges.size(); ++i) {
+                if(edges[i].first <= kMaxChar) {
+                    (*index)[edges[i].first - kMinChar] = i;
+                }
+            }
+        }
+
+        // Keeps the index valid after an insertion at position, without a
+        // rescan of the edges. Terminators sort after every char, so adding
+        // one moves nothing; the root of a generalized tree gets one per
+        // string.
+        void m_shiftIndex(Letter ch, size_t position) {
+            if(ch > kMaxChar) {
+                return;
+            }
+            for(auto& entry: *index) {
+                if((entry != kNoEdge) && (entry >= position)) {
+                    ++entry;
+                }
+            }
+            (*index)[ch - kMinChar] = position;
+        }
+    };
+
     struct Node {
         T start;
         T end;
-        std::map<char, Node*> children;
+        Children children;
         Node* suffixLink;
         SuffixTree* suffixTree;
+        // Number of leaves in the subtree, valid after m_countLeaves().
+        T leaves;
 
-        Node(T start, T end, SuffixTree* suffixTree): start(start), end(end), suffixTree(suffixTree)
+        Node(T start, T end, SuffixTree* suffixTree): start(start), end(end), suffixTree(suffixTree), leaves(0)
         {}
 
-        T getEdgeLength() {
+        T getEdgeLength() const {
             if(end == suffixTree->kLastPosition) {
                 return suffixTree->currentLength - start;
             }
@@ -28,21 +191,21 @@ public:
 
     struct ImplicitNode {
         Node* vertex;
-        char ch;
+        Letter ch;
         T edgeLength;
 
         void canonize() {
             if(edgeLength == 0) {
                 return;
             }
-            Node* child = vertex->children[ch];
+            Node* child = vertex->children.find(ch);
             T actualEdgeLength = child->getEdgeLength();
             while(actualEdgeLength <= edgeLength) {
                 vertex = child;
                 edgeLength -= actualEdgeLength;
                 if(edgeLength != 0) {
-                    ch = vertex->suffixTree->text[vertex->suffixTree->currentLength - edgeLength];
-                    child = vertex->children[ch];
+                    ch = vertex->suffixTree->m_letter(vertex->suffixTree->currentLength - edgeLength);
+                    child = vertex->children.find(ch);
                     actualEdgeLength = child->getEdgeLength();
                 }
             }
@@ -54,32 +217,250 @@ public:
             }
             else if (edgeLength > 0) {
                 --edgeLength;
-                ch = vertex->suffixTree->text[vertex->suffixTree->currentLength - edgeLength];
+                ch = vertex->suffixTree->m_letter(vertex->suffixTree->currentLength - edgeLength);
             }
         }
 
         void moveForward() {
             ++edgeLength;
             if(edgeLength == 1) {
-                ch = vertex->suffixTree->text[vertex->suffixTree->currentLength];
+                ch = vertex->suffixTree->m_letter(vertex->suffixTree->currentLength);
             }
         }
     };
 
-    SuffixTree(): root(new Node(0, 0, this)), activePoint{root, '\0', 0},
-        currentLength(0), size(1) {
-        splitPosition = text.find('$');
-        m_ukkonen();
+    SuffixTree(): currentLength(0), root(new Node(0, 0, this)), activePoint{root, '\0', 0},
+        splitPosition(kLastPosition), size(1)
+    {}
+
+    // Text is copied, so it may be a view of a temporary buffer or an mmap'd
+    // file. The last letter should be unique to make every suffix a leaf.
+    explicit SuffixTree(std::string_view text): SuffixTree() {
+        append(text);
     }
 
+    // Linear construction from the suffix array of text and its LCP, where
+    // lcp[i] is LCP of suffixes suffixArray[i] and suffixArray[i + 1]: the
+    // rightmost path is kept on a stack like in a Cartesian tree. Text should
+    // end with a unique letter. Suffix links are not built, so such a tree
+    // can not be appended to.
+    SuffixTree(std::string_view text, const std::vector<T>& suffixArray, const std::vector<T>& lcp):
+        SuffixTree() {
+        this->text = text;
+        currentLength = text.size();
+        auto split = text.find('$');
+        if(split != std::string_view::npos) {
+            splitPosition = split;
+        }
+
+        std::vector<std::pair<Node*, T>> stack = {{root, 0}};
+        for(size_t i = 0; i < suffixArray.size(); ++i) {
+            T common = (i == 0) ? 0 : lcp[i - 1];
+            Node* last = nullptr;
+            while(stack.back().second > common) {
+                last = stack.back().first;
+                stack.pop_back();
+            }
+
+            if(stack.back().second < common) {
+                auto [parent, parentDepth] = stack.back();
+                auto middle = new Node(last->start, last->start + common - parentDepth, this);
+                last->start = middle->end;
+                middle->children.set(m_letter(last->start), last);
+                parent->children.set(m_letter(middle->start), middle);
+                ++size;
+                stack.emplace_back(middle, common);
+            }
+
+            auto leaf = new Node(suffixArray[i] + common, kLastPosition, this);
+            stack.back().first->children.set(m_letter(leaf->start), leaf);
+            ++size;
+            stack.emplace_back(leaf, static_cast<T>(text.size()) - suffixArray[i]);
+        }
+    }
+
+    SuffixTree(const SuffixTree&) = delete;
+    SuffixTree& operator=(const SuffixTree&) = delete;
+
     ~SuffixTree() {
         m_clean(root);
     }
 
-    void dfs() {
-        T id = 0;
-        std::cout << size << std::endl;
-        m_dfs(root, id, id);
+    // Extends the tree online by Ukkonen's algorithm, chunk by chunk.
+    void append(std::string_view chunk) {
+        if(splitPosition == kLastPosition) {
+            auto split = chunk.find('$');
+            if(split != std::string_view::npos) {
+                splitPosition = text.size() + split;
+            }
+        }
+        m_extend(chunk);
+    }
+
+    // Generalized suffix tree: every string is closed by its own virtual
+    // terminator, which differs from any letter, so each suffix of each
+    // string ends in a leaf. Returns number of the string. Should not be
+    // mixed with append().
+    T addString(std::string_view str) {
+        stringBegin.push_back(text.size());
+        stringEnd.push_back(text.size() + str.size());
+        m_extend(str);
+        m_extend(std::string_view(&kTerminator, 1));
+        return stringBegin.size() - 1;
+    }
+
+    size_t strings() const {
+        return stringBegin.empty() ? ((splitPosition == kLastPosition) ? 1 : 2) : stringBegin.size();
+    }
+
+    // Nodes in preorder, one per line "parent string start end", positions are
+    // inside the string. The first line is the number of nodes with the root.
+    void exportText(std::FILE* file) const {
+        BufferedWriter writer(file);
+        writer.writeNumber(size);
+        writer.writeChar('\n');
+        m_preorder([&writer](T parentID, T stringID, T start, T end) {
+            writer.writeNumber(parentID);
+            writer.writeChar(' ');
+            writer.writeNumber(stringID);
+            writer.writeChar(' ');
+            writer.writeNumber(start);
+            writer.writeChar(' ');
+            writer.writeNumber(end);
+            writer.writeChar('\n');
+        });
+    }
+
+    // The same as exportText: uint64_t number of nodes, then four T per node.
+    void exportBinary(std::FILE* file) const {
+        BufferedWriter writer(file);
+        uint64_t nodes = size;
+        writer.write(&nodes, sizeof(nodes));
+        m_preorder([&writer](T parentID, T stringID, T start, T end) {
+            T record[4] = {parentID, stringID, start, end};
+            writer.write(record, sizeof(record));
+        });
+    }
+
+    void dfs() const {
+        std::fflush(stdout);
+        exportText(stdout);
+    }
+
+    // Suffix array and LCP (lcp[i] for suffixes i and i + 1) by one walk
+    // over leaves in order of letters, linear in the size of the tree. LCP of
+    // two neighbouring leaves is the smallest depth passed between them.
+    std::pair<std::vector<T>, std::vector<T>> toSuffixArray() const {
+        std::vector<T> suffixArray, lcp;
+        suffixArray.reserve(currentLength);
+        lcp.reserve(currentLength);
+
+        T common = 0;
+        std::vector<std::pair<const Node*, T>> stack = {{root, 0}};
+        while(!stack.empty()) {
+            auto [vertex, parentDepth] = stack.back();
+            stack.pop_back();
+            common = std::min(common, parentDepth);
+
+            if(vertex->children.size() == 0) {
+                if(!suffixArray.empty()) {
+                    lcp.push_back(common);
+                }
+                suffixArray.push_back(vertex->start - parentDepth);
+                common = std::numeric_limits<T>::max();
+                continue;
+            }
+
+            T depth = parentDepth + ((vertex == root) ? 0 : vertex->getEdgeLength());
+            for(auto child = vertex->children.end(); child != vertex->children.begin(); ) {
+                --child;
+                stack.emplace_back(child->second, depth);
+            }
+        }
+        if(!suffixArray.empty()) {
+            lcp.push_back(0);
+        }
+
+        return std::make_pair(std::move(suffixArray), std::move(lcp));
+    }
+
+    // Queries below expect every suffix to end in a leaf: the text is closed
+    // by a unique letter or strings are added by addString(). Returned views
+    // point into the tree text and live until the next append.
+
+    bool contains(std::string_view pattern) const {
+        return m_locate(pattern) != nullptr;
+    }
+
+    // Number of occurrences in O(|pattern|), leaf counts are cached.
+    T count(std::string_view pattern) const {
+        m_countLeaves();
+        auto vertex = m_locate(pattern);
+        return (vertex == nullptr) ? 0 : vertex->leaves;
+    }
+
+    std::vector<bool> contains(const std::vector<std::string_view>& patterns) const {
+        std::vector<bool> answer(patterns.size());
+        for(size_t i = 0; i < patterns.size(); ++i) {
+            answer[i] = contains(patterns[i]);
+        }
+        return answer;
+    }
+
+    std::vector<T> count(const std::vector<std::string_view>& patterns) const {
+        m_countLeaves();
+        std::vector<T> answer(patterns.size());
+        for(size_t i = 0; i < patterns.size(); ++i) {
+            auto vertex = m_locate(patterns[i]);
+            answer[i] = (vertex == nullptr) ? 0 : vertex->leaves;
+        }
+        return answer;
+    }
+
+    // The deepest internal node.
+    std::string_view longestRepeatedSubstring() const {
+        std::string_view answer;
+        m_fold<bool>([](T) { return true; }, [](bool a, bool) { return a; },
+                     [this, &answer](const Node* vertex, T depth, bool) {
+            if(!vertex->children.size() || (depth <= static_cast<T>(answer.size()))) {
+                return;
+            }
+            answer = m_label(vertex, depth);
+        });
+        return answer;
+    }
+
+    // The deepest node with leaves of strings 0 and 1 in the subtree.
+    std::string_view longestCommonSubstring() const {
+        auto borders = m_stringBorders();
+        std::string_view answer;
+        m_fold<unsigned>([&borders](T start) {
+                             T stringID = m_stringOf(borders.first, start);
+                             return (stringID < 2) ? (1u << stringID) : 0u;
+                         },
+                         [](unsigned a, unsigned b) { return a | b; },
+                         [this, &answer](const Node* vertex, T depth, unsigned mask) {
+            if(!vertex->children.size() || (mask != 3u) || (depth <= static_cast<T>(answer.size()))) {
+                return;
+            }
+            answer = m_label(vertex, depth);
+        });
+        return answer;
+    }
+
+    // Substrings which occur twice and can be extended neither to the right
+    // (internal node) nor to the left (different letters before occurrences).
+    std::vector<std::string_view> maximalRepeats(size_t minLength = 1) const {
+        std::vector<std::string_view> answer;
+        m_fold<Letter>([this](T start) { return (start == 0) ? kDiverse : m_letter(start - 1); },
+                       [](Letter a, Letter b) { return (a == b) ? a : kDiverse; },
+                       [this, &answer, minLength](const Node* vertex, T depth, Letter left) {
+            if(vertex->children.size() && (vertex != root) && (left == kDiverse) &&
+               (static_cast<size_t>(depth) >= minLength)) {
+                answer.push_back(m_label(vertex, depth));
+            }
+        });
+        return answer;
     }
 
     T currentLength;
@@ -89,27 +470,32 @@ private:
     std::string text;
     T splitPosition;
     size_t size;
+    std::vector<T> stringBegin;
+    std::vector<T> stringEnd;
+    mutable bool leavesCounted = false;
 
     static const T kLastPosition = std::numeric_limits<T>::max();
+    static constexpr char kTerminator = '\0';
+    static const Letter kFirstTerminator = std::numeric_limits<unsigned char>::max() + 1;
+    static constexpr Letter kDiverse = std::numeric_limits<Letter>::min();
 
-    void m_ukkonen() {
-        T i = 0;
-        char c;
-        std::scanf("%c", &c);
-        while(c != '#') {
-            if(c != '\n') {
-                if(c == '$') {
-                    splitPosition = i;
-                }
-
-                text += c;
-                m_addLetter(i);
-                ++i;
+    Letter m_letter(T position) const {
+        if((text[position] == kTerminator) && !stringEnd.empty()) {
+            auto it = std::lower_bound(stringEnd.begin(), stringEnd.end(), position);
+            if((it != stringEnd.end()) && (*it == position)) {
+                return kFirstTerminator + (it - stringEnd.begin());
             }
-            std::scanf("%c", &c);
         }
-        text += '#';
-        m_addLetter(i);
+        return text[position];
+    }
+
+    void m_extend(std::string_view chunk) {
+        leavesCounted = false;
+        T position = text.size();
+        text.append(chunk.begin(), chunk.end());
+        for(; position < static_cast<T>(text.size()); ++position) {
+            m_addLetter(position);
+        }
     }
 
     void m_addLetter(T position) {
@@ -124,7 +510,7 @@ private:
 
             if(!endPoint) {
                 auto newLeaf = new Node(position, kLastPosition, this);
-                parent->children[text[position]] = newLeaf;
+                parent->children.set(m_letter(position), newLeaf);
                 ++size;
 
                 lastNewNode = parent;
@@ -140,25 +526,25 @@ private:
     }
 
     bool m_testAndSplit(T position, Node*& newNode) {
-        char newChar = text[position];
+        Letter newChar = m_letter(position);
         activePoint.canonize();
         Node* parent = activePoint.vertex;
 
         if(activePoint.edgeLength == 0) {
             newNode = parent;
-            return parent->children[newChar] != nullptr;
+            return parent->children.find(newChar) != nullptr;
         }
 
-        Node* child = parent->children[activePoint.ch];
+        Node* child = parent->children.find(activePoint.ch);
         T splitPosition = child->start + activePoint.edgeLength;
 
-        if(text[splitPosition] == newChar) {
+        if(m_letter(splitPosition) == newChar) {
             return true;
         }
         else {
             newNode = new Node(child->start, splitPosition, this);
-            newNode->children[text[splitPosition]] = child;
-            parent->children[activePoint.ch] = newNode;
+            newNode->children.set(m_letter(splitPosition), child);
+            parent->children.set(activePoint.ch, newNode);
             ++size;
             child->start = splitPosition;
             return false;
@@ -166,40 +552,320 @@ private:
     }
 
 
-    void m_dfs(Node* root, T parentID, T& prevID) {
-        T start = root->start;
-        T end = start + root->getEdgeLength();
-        T gap = 0;
-        T id = prevID;
+    // Calls visit(parentID, stringID, start, end) for every node except the
+    // root in preorder. Edges are cut by the end of their string.
+    template<typename Visitor>
+    void m_preorder(Visitor visit) const {
+        auto [begins, ends] = m_stringBorders();
+
+        T id = 0;
+        std::vector<std::pair<const Node*, T>> stack = {{root, 0}};
+        while(!stack.empty()) {
+            auto [vertex, parentID] = stack.back();
+            stack.pop_back();
+            T vertexID = id++;
 
-        bool strID = start > splitPosition;
-        if(start > splitPosition) {
-            gap = splitPosition + 1;
+            if(vertex != root) {
+                T start = vertex->start;
+                T end = start + vertex->getEdgeLength();
+                T stringID = m_stringOf(begins, start);
+                end = std::min(end, ends[stringID]);
+                visit(parentID, stringID, start - begins[stringID], end - begins[stringID]);
+            }
+
+            for(auto child = vertex->children.end(); child != vertex->children.begin(); ) {
+                --child;
+                stack.emplace_back(child->second, vertexID);
+            }
         }
-        else if(end > splitPosition) {
-            end = splitPosition + 1;
+    }
+
+    // Begins and ends of strings in the text for both modes.
+    std::pair<std::vector<T>, std::vector<T>> m_stringBorders() const {
+        std::vector<T> begins = stringBegin, ends = stringEnd;
+        if(begins.empty()) {
+            begins = {0};
+            ends = {static_cast<T>(text.size())};
+            if(splitPosition != kLastPosition) {
+                begins.push_back(splitPosition + 1);
+                ends.front() = splitPosition + 1;
+                ends.push_back(text.size());
+            }
+        }
+        return std::make_pair(std::move(begins), std::move(ends));
+    }
+
+    static T m_stringOf(const std::vector<T>& begins, T position) {
+        return std::upper_bound(begins.begin(), begins.end(), position) - begins.begin() - 1;
+    }
+
+    std::string_view m_label(const Node* vertex, T depth) const {
+        return std::string_view(text).substr(vertex->end - depth, depth);
+    }
+
+    // The node at or below the end of pattern, nullptr if there is no such path.
+    const Node* m_locate(std::string_view pattern) const {
+        const Node* vertex = root;
+        size_t i = 0;
+        while(i < pattern.size()) {
+            vertex = vertex->children.find(pattern[i]);
+            if(vertex == nullptr) {
+                return nullptr;
+            }
+            T length = vertex->getEdgeLength();
+            for(T j = 0; (j < length) && (i < pattern.size()); ++j, ++i) {
+                if(m_letter(vertex->start + j) != pattern[i]) {
+                    return nullptr;
+                }
+            }
         }
+        return vertex;
+    }
 
-        if(root != this->root) {
-            std::printf("%d %d %d %d\n", parentID, strID, start - gap, end - gap);
+    void m_countLeaves() const {
+        if(leavesCounted) {
+            return;
         }
+        m_fold<T>([](T) { return 1; }, [](T a, T b) { return a + b; },
+                  [](Node* vertex, T, T leaves) { vertex->leaves = leaves; });
+        leavesCounted = true;
+    }
+
+    // Postorder walk with an explicit stack. A leaf gets leafValue(start of
+    // its suffix), an internal node combines values of its children; then
+    // visit(node, string depth, value) is called.
+    template<typename Value, typename LeafValue, typename Combine, typename Visitor>
+    void m_fold(LeafValue leafValue, Combine combine, Visitor visit) const {
+        struct Frame {
+            Node* vertex;
+            T depth;
+            size_t nextChild;
+            Value value;
+        };
 
-        for(auto child: root->children) {
-            m_dfs(child.second, id, ++prevID);
+        std::vector<Frame> stack = {{root, 0, 0, Value()}};
+        while(!stack.empty()) {
+            auto& frame = stack.back();
+            if((frame.vertex->children.size() == 0) && (frame.vertex != root)) {
+                T parentDepth = stack[stack.size() - 2].depth;
+                frame.value = leafValue(frame.vertex->start - parentDepth);
+            }
+            else if(frame.nextChild < frame.vertex->children.size()) {
+                Node* child = (frame.vertex->children.begin() + frame.nextChild++)->second;
+                stack.push_back({child, frame.depth + child->getEdgeLength(), 0, Value()});
+                continue;
+            }
+
+            Frame done = frame;
+            stack.pop_back();
+            visit(done.vertex, done.depth, done.value);
+            if(!stack.empty()) {
+                auto& parent = stack.back();
+                parent.value = (parent.nextChild == 1) ? done.value : combine(parent.value, done.value);
+            }
         }
     }
 
     void m_clean(Node* vertex) {
-        for(auto child: vertex->children) {
-            m_clean(child.second);
+        std::vector<Node*> stack = {vertex};
+        while(!stack.empty()) {
+            vertex = stack.back();
+            stack.pop_back();
+            for(auto child: vertex->children) {
+                stack.push_back(child.second);
+            }
+            delete vertex;
         }
-        delete vertex;
+    }
+};
+
+
+// Suffix automaton built online, states and transitions live in flat
+// vectors. Transitions of a state form a singly linked list inside the edge
+// arrays: nine bytes per edge and no allocation per state.
+template<typename T>
+class SuffixAutomaton {
+public:
+    SuffixAutomaton(): last(0), distinct(0) {
+        states.push_back({0, kNone, kNone, false});
+    }
+
+    explicit SuffixAutomaton(std::string_view text): SuffixAutomaton() {
+        append(text);
+    }
+
+    void append(std::string_view chunk) {
+        occurrencesCounted = false;
+        // At most 2 states and 3 edges per letter.
+        m_reserve(states, states.size() + 2 * chunk.size());
+        m_reserve(edgeTarget, edgeTarget.size() + 3 * chunk.size());
+        m_reserve(edgeNext, edgeNext.size() + 3 * chunk.size());
+        m_reserve(edgeLetter, edgeLetter.size() + 3 * chunk.size());
+        for(auto c: chunk) {
+            m_addLetter(c);
+        }
+    }
+
+    bool contains(std::string_view pattern) const {
+        return m_locate(pattern) != kNone;
+    }
+
+    // Number of occurrences, end position sets are counted once and cached.
+    T count(std::string_view pattern) const {
+        m_countOccurrences();
+        T state = m_locate(pattern);
+        return (state == kNone) ? 0 : occurrences[state];
+    }
+
+    // Number of different non-empty substrings, kept up to date by append.
+    unsigned long long distinctSubstrings() const {
+        return distinct;
+    }
+
+    size_t size() const {
+        return states.size();
+    }
+
+    size_t memory() const {
+        return states.capacity() * sizeof(State) + edgeTarget.capacity() * sizeof(T) +
+               edgeNext.capacity() * sizeof(T) + edgeLetter.capacity() * sizeof(char);
+    }
+
+private:
+    struct State {
+        T length;
+        T link;
+        T firstEdge;
+        bool cloned;
+    };
+
+    static const T kNone = -1;
+
+    std::vector<State> states;
+    std::vector<T> edgeTarget;
+    std::vector<T> edgeNext;
+    std::vector<char> edgeLetter;
+    T last;
+    unsigned long long distinct;
+    mutable std::vector<T> occurrences;
+    mutable bool occurrencesCounted = false;
+
+    // Capacity grows at least twice, so appending letter by letter stays
+    // amortized O(1) per letter.
+    template<typename Element>
+    static void m_reserve(std::vector<Element>& vector, size_t size) {
+        if(size > vector.capacity()) {
+            vector.reserve(std::max(size, 2 * vector.capacity()));
+        }
+    }
+
+    T m_find(T state, char c) const {
+        for(T e = states[state].firstEdge; e != kNone; e = edgeNext[e]) {
+            if(edgeLetter[e] == c) {
+                return e;
+            }
+        }
+        return kNone;
+    }
+
+    T m_next(T state, char c) const {
+        T e = m_find(state, c);
+        return (e == kNone) ? kNone : edgeTarget[e];
+    }
+
+    void m_addEdge(T state, char c, T target) {
+        edgeTarget.push_back(target);
+        edgeNext.push_back(states[state].firstEdge);
+        edgeLetter.push_back(c);
+        states[state].firstEdge = edgeTarget.size() - 1;
+    }
+
+    void m_addLetter(char c) {
+        T current = states.size();
+        states.push_back({states[last].length + 1, kNone, kNone, false});
+
+        T p = last;
+        while((p != kNone) && (m_find(p, c) == kNone)) {
+            m_addEdge(p, c, current);
+            p = states[p].link;
+        }
+
+        if(p == kNone) {
+            states[current].link = 0;
+        }
+        else {
+            T q = m_next(p, c);
+            if(states[p].length + 1 == states[q].length) {
+                states[current].link = q;
+            }
+            else {
+                T clone = states.size();
+                states.push_back({states[p].length + 1, states[q].link, kNone, true});
+                for(T e = states[q].firstEdge; e != kNone; e = edgeNext[e]) {
+                    m_addEdge(clone, edgeLetter[e], edgeTarget[e]);
+                }
+                T e;
+                while((p != kNone) && ((e = m_find(p, c)) != kNone) && (edgeTarget[e] == q)) {
+                    edgeTarget[e] = clone;
+                    p = states[p].link;
+                }
+                states[q].link = clone;
+                states[current].link = clone;
+            }
+        }
+
+        last = current;
+        distinct += states[current].length - states[states[current].link].length;
+    }
+
+    T m_locate(std::string_view pattern) const {
+        T state = 0;
+        for(auto c: pattern) {
+            state = m_next(state, c);
+            if(state == kNone) {
+                return kNone;
+            }
+        }
+        return state;
+    }
+
+    // Sizes of end position sets: every non-clone state adds one to all states
+    // on its suffix link path, so states are processed by decreasing length.
+    void m_countOccurrences() const {
+        if(occurrencesCounted) {
+            return;
+        }
+        std::vector<T> count(states[last].length + 2, 0), order(states.size());
+        for(auto& state: states) {
+            ++count[state.length];
+        }
+        for(size_t i = 1; i < count.size(); ++i) {
+            count[i] += count[i - 1];
+        }
+        for(size_t i = states.size(); i > 0; --i) {
+            order[--count[states[i - 1].length]] = i - 1;
+        }
+
+        occurrences.assign(states.size(), 0);
+        for(size_t i = 0; i < states.size(); ++i) {
+            occurrences[i] = states[i].cloned ? 0 : 1;
+        }
+        for(size_t i = order.size(); i > 1; --i) {
+            T v = order[i - 1];
+            occurrences[states[v].link] += occurrences[v];
+        }
+        occurrencesCounted = true;
     }
 };
 
 
 int main() {
-    SuffixTree<int> suffixTree;
+    std::string text;
+    std::getline(std::cin, text, '#');
+    text.erase(std::remove(text.begin(), text.end(), '\n'), text.end());
+    text += '#';
+
+    SuffixTree<int> suffixTree(text);
     suffixTree.dfs();
     return 0;
 }
\ No newline at end of file
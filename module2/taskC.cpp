@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <numeric>
 #include <string>
+#include <deque>
 
 template<typename T>
 class SuffixArray {
@@ -149,6 +150,420 @@ private:
 };
 
 
+// Suffix array over many documents at once. Suffixes never run across document
+// borders, so no separator symbols are needed; equal suffixes of different
+// documents are ordered by document number.
+template<typename T>
+class GeneralizedSuffixArray {
+public:
+    explicit GeneralizedSuffixArray(const std::vector<std::string_view>& documents) {
+        documentBegin.reserve(documents.size() + 1);
+        size_t totalSize = 0, maxSize = 0;
+        for(auto document: documents) {
+            totalSize += document.size();
+            maxSize = std::max(maxSize, document.size());
+        }
+        text.reserve(totalSize);
+        for(auto document: documents) {
+            documentBegin.push_back(text.size());
+            text += document;
+        }
+        documentBegin.push_back(text.size());
+
+        m_buildArray(maxSize);
+        m_buildDocumentIDs();
+        m_buildPrevious();
+    }
+
+    T const& operator[](size_t it) const {
+        return array[it];
+    }
+
+    size_t size() const {
+        return array.size();
+    }
+
+    size_t documents() const {
+        return documentBegin.size() - 1;
+    }
+
+    // Number of document, which contains suffix array[it].
+    T document(size_t it) const {
+        return documentID[it];
+    }
+
+    std::vector<T> const& documentIDs() const {
+        return documentID;
+    }
+
+    std::string_view value() const {
+        return text;
+    }
+
+    // Document d occupies [borders[d], borders[d + 1]) of value().
+    std::vector<T> const& borders() const {
+        return documentBegin;
+    }
+
+    // Suffix array[it] cut by the end of its document.
+    std::string_view suffix(size_t it) const {
+        return std::string_view(text).substr(array[it], documentBegin[documentID[it] + 1] - array[it]);
+    }
+
+    // Half-interval [first, second) of suffixes starting with pattern.
+    std::pair<size_t, size_t> find(std::string_view pattern) const {
+        size_t left = 0, right = array.size();
+        while(left < right) {
+            size_t m = (left + right) / 2;
+            if(suffix(m).substr(0, pattern.size()) < pattern) {
+                left = m + 1;
+            }
+            else {
+                right = m;
+            }
+        }
+
+        size_t first = left;
+        right = array.size();
+        while(left < right) {
+            size_t m = (left + right) / 2;
+            if(suffix(m).substr(0, pattern.size()) == pattern) {
+                left = m + 1;
+            }
+            else {
+                right = m;
+            }
+        }
+
+        return std::make_pair(first, left);
+    }
+
+    // Every document containing pattern exactly once, in O(|P| log n + answer).
+    // Muthukrishnan: suffix i is the first of its document in [l, r) iff previous[i] < l.
+    std::vector<T> listDocuments(std::string_view pattern) const {
+        std::vector<T> answer;
+        auto interval = find(pattern);
+        if(interval.first == interval.second) {
+            return answer;
+        }
+
+        T left = interval.first;
+        std::vector<std::pair<size_t, size_t>> stack = {interval};
+        while(!stack.empty()) {
+            auto [l, r] = stack.back();
+            stack.pop_back();
+            size_t k = m_minPrevious(l, r);
+            if(previous[k] >= left) {
+                continue;
+            }
+            answer.push_back(documentID[k]);
+            if(l < k) {
+                stack.emplace_back(l, k);
+            }
+            if(k + 1 < r) {
+                stack.emplace_back(k + 1, r);
+            }
+        }
+
+        return answer;
+    }
+
+private:
+    void m_buildArray(size_t maxSize) {
+        size_t size = text.size();
+        array.assign(size, 0);
+        std::vector<T> position(size), eqClass(size), newEqClass(size);
+        for(size_t d = 0; d + 1 < documentBegin.size(); ++d) {
+            for(size_t i = documentBegin[d]; i < documentBegin[d + 1]; ++i) {
+                position[i] = d;
+            }
+        }
+
+        // Classes start from 1, 0 is an empty string behind the end of a document.
+        std::vector<size_t> count(std::max<size_t>(size, kAlphabetSize) + 1, 0);
+        for(auto c: text) {
+            ++count[static_cast<unsigned char>(c)];
+        }
+        for(size_t i = 1; i < kAlphabetSize; ++i) {
+            count[i] += count[i - 1];
+        }
+        for(size_t i = size; i > 0; --i) {
+            array[--count[static_cast<unsigned char>(text[i - 1])]] = i - 1;
+        }
+
+        size_t classes = 0;
+        for(size_t i = 0; i < size; ++i) {
+            if((i == 0) || (text[array[i]] != text[array[i - 1]])) {
+                ++classes;
+            }
+            eqClass[array[i]] = classes;
+        }
+
+        std::vector<T> array_2_k(size);
+        for(size_t h = 1; (h < maxSize) && (classes < size); h <<= 1) {
+            auto secondClass = [&](T i) {
+                return (i + h < documentBegin[position[i] + 1]) ? eqClass[i + h] : 0;
+            };
+
+            // Sort by the second half: suffixes shorter than h go first.
+            size_t it = 0;
+            for(size_t i = 0; i < size; ++i) {
+                if(i + h >= documentBegin[position[i] + 1]) {
+                    array_2_k[it++] = i;
+                }
+            }
+            for(size_t i = 0; i < size; ++i) {
+                if((array[i] >= documentBegin[position[array[i]]] + h)) {
+                    array_2_k[it++] = array[i] - h;
+                }
+            }
+
+            count.assign(classes + 2, 0);
+            for(size_t i = 0; i < size; ++i) {
+                ++count[eqClass[i]];
+            }
+            for(size_t i = 1; i < classes + 2; ++i) {
+                count[i] += count[i - 1];
+            }
+            for(size_t i = size; i > 0; --i) {
+                array[--count[eqClass[array_2_k[i - 1]]]] = array_2_k[i - 1];
+            }
+
+            classes = 0;
+            for(size_t i = 0; i < size; ++i) {
+                if((i == 0) || (eqClass[array[i]] != eqClass[array[i - 1]]) ||
+                   (secondClass(array[i]) != secondClass(array[i - 1]))) {
+                    ++classes;
+                }
+                newEqClass[array[i]] = classes;
+            }
+            std::swap(newEqClass, eqClass);
+        }
+    }
+
+    void m_buildDocumentIDs() {
+        documentID.assign(array.size(), 0);
+        for(size_t i = 0; i < array.size(); ++i) {
+            documentID[i] = std::upper_bound(documentBegin.begin(), documentBegin.end(), array[i]) -
+                            documentBegin.begin() - 1;
+        }
+    }
+
+    void m_buildPrevious() {
+        size_t size = array.size();
+        previous.assign(size, -1);
+        std::vector<T> last(documents(), -1);
+        for(size_t i = 0; i < size; ++i) {
+            previous[i] = last[documentID[i]];
+            last[documentID[i]] = i;
+        }
+
+        // Sparse table over minimums of blocks, inside a block we scan.
+        size_t blocks = (size + kBlockSize - 1) / kBlockSize;
+        sparseTable.assign(1, std::vector<T>(blocks));
+        for(size_t b = 0; b < blocks; ++b) {
+            sparseTable[0][b] = m_scanPrevious(b * kBlockSize, std::min(size, (b + 1) * kBlockSize));
+        }
+        for(size_t k = 1; (static_cast<size_t>(1) << k) <= blocks; ++k) {
+            auto& prevLevel = sparseTable[k - 1];
+            std::vector<T> level(blocks - (static_cast<size_t>(1) << k) + 1);
+            for(size_t i = 0; i < level.size(); ++i) {
+                level[i] = m_better(prevLevel[i], prevLevel[i + (static_cast<size_t>(1) << (k - 1))]);
+            }
+            sparseTable.push_back(std::move(level));
+        }
+    }
+
+    T m_better(T a, T b) const {
+        return (previous[a] <= previous[b]) ? a : b;
+    }
+
+    T m_scanPrevious(size_t left, size_t right) const {
+        T best = left;
+        for(size_t i = left + 1; i < right; ++i) {
+            best = m_better(best, i);
+        }
+        return best;
+    }
+
+    size_t m_minPrevious(size_t left, size_t right) const {
+        size_t firstBlock = (left + kBlockSize - 1) / kBlockSize, lastBlock = right / kBlockSize;
+        if(firstBlock >= lastBlock) {
+            return m_scanPrevious(left, right);
+        }
+
+        size_t k = 0;
+        while((static_cast<size_t>(2) << k) <= lastBlock - firstBlock) {
+            ++k;
+        }
+        T best = m_better(sparseTable[k][firstBlock], sparseTable[k][lastBlock - (static_cast<size_t>(1) << k)]);
+        if(left < firstBlock * kBlockSize) {
+            best = m_better(m_scanPrevious(left, firstBlock * kBlockSize), best);
+        }
+        if(lastBlock * kBlockSize < right) {
+            best = m_better(best, m_scanPrevious(lastBlock * kBlockSize, right));
+        }
+        return best;
+    }
+
+    static const size_t kAlphabetSize = 256;
+    static const size_t kBlockSize = 32;
+    std::string text;
+    std::vector<T> documentBegin;
+    std::vector<T> array;
+    std::vector<T> documentID;
+    std::vector<T> previous;
+    std::vector<std::vector<T>> sparseTable;
+};
+
+
+template<typename T>
+class GeneralizedLCP {
+public:
+    // array[i] is LCP of suffixes i and i + 1, it never crosses a document border.
+    explicit GeneralizedLCP(GeneralizedSuffixArray<T>& suffixArray) {
+        std::string_view text = suffixArray.value();
+        auto& borders = suffixArray.borders();
+        array.assign(text.size(), 0);
+
+        std::vector<T> positionOfSuffix(text.size(), 0);
+        for(size_t i = 0; i < suffixArray.size(); ++i) {
+            positionOfSuffix[suffixArray[i]] = i;
+        }
+
+        for(size_t d = 0; d + 1 < borders.size(); ++d) {
+            size_t equalLetters = 0;
+            for(size_t i = borders[d]; i < borders[d + 1]; ++i) {
+                if(equalLetters > 0) {
+                    --equalLetters;
+                }
+
+                size_t it = positionOfSuffix[i];
+                if(it + 1 == suffixArray.size()) {
+                    equalLetters = 0;
+                    continue;
+                }
+                size_t j = suffixArray[it + 1];
+                size_t jEnd = borders[suffixArray.document(it + 1) + 1];
+                while((i + equalLetters < borders[d + 1]) && (j + equalLetters < jEnd) &&
+                      (text[i + equalLetters] == text[j + equalLetters])) {
+                    ++equalLetters;
+                }
+                array[it] = equalLetters;
+            }
+        }
+    }
+
+    T const& operator[](size_t it) const {
+        return array[it];
+    }
+
+    size_t size() const {
+        return array.size();
+    }
+
+    std::vector<T> const& value() const {
+        return array;
+    }
+
+private:
+    std::vector<T> array;
+};
+
+
+// Up to k longest distinct substrings common to at least m documents, as pairs
+// (position in suffixArray.value(), length), longest first. For every left end
+// the shortest window of suffixes covering m documents is found with two
+// pointers, its LCP is the minimum kept in a monotonic deque. Every window
+// gives the longest prefix shared by its m documents, so the whole scan is O(n).
+// A window is reported only if its occurrences are left-maximal: when all of
+// them follow the same letter, that letter and the prefix are common to the
+// same documents, so the prefix is only a suffix of a longer answer.
+template<typename T>
+std::vector<std::pair<size_t, size_t>> topCommonSubStrings(GeneralizedSuffixArray<T>& suffixArray,
+                                                           GeneralizedLCP<T>& lcp, size_t m, size_t k) {
+    std::vector<std::pair<size_t, size_t>> answer;
+    if((m == 0) || (m > suffixArray.documents()) || (k == 0)) {
+        return answer;
+    }
+
+    std::string_view text = suffixArray.value();
+    auto& borders = suffixArray.borders();
+    auto startsDocument = [&](size_t it) {
+        return static_cast<size_t>(suffixArray[it]) == static_cast<size_t>(borders[suffixArray.document(it)]);
+    };
+    // Whether suffixes it and it + 1 follow the same letter.
+    auto sameLetterBefore = [&](size_t it) {
+        return !startsDocument(it) && !startsDocument(it + 1) &&
+               (text[suffixArray[it] - 1] == text[suffixArray[it + 1] - 1]);
+    };
+
+    std::vector<size_t> inWindow(suffixArray.documents(), 0);
+    std::deque<size_t> minLCP;
+    // Lengths of already reported strings whose LCP-interval is still open, increasing.
+    std::vector<size_t> reported;
+    // Neighbours in the window following different letters.
+    size_t covered = 0, right = 0, differentLetters = 0;
+    for(size_t left = 0; left < suffixArray.size(); ++left) {
+        if(left > 0) {
+            while(!reported.empty() && (reported.back() > static_cast<size_t>(lcp[left - 1]))) {
+                reported.pop_back();
+            }
+        }
+
+        while((covered < m) && (right < suffixArray.size())) {
+            if(inWindow[suffixArray.document(right)]++ == 0) {
+                ++covered;
+            }
+            if(right > left) {
+                while(!minLCP.empty() && (lcp[minLCP.back()] >= lcp[right - 1])) {
+                    minLCP.pop_back();
+                }
+                minLCP.push_back(right - 1);
+                if(!sameLetterBefore(right - 1)) {
+                    ++differentLetters;
+                }
+            }
+            ++right;
+        }
+        if(covered < m) {
+            break;
+        }
+
+        size_t length = minLCP.empty() ? suffixArray.suffix(left).size() : lcp[minLCP.front()];
+        while(!reported.empty() && (reported.back() > length)) {
+            reported.pop_back();
+        }
+        bool leftMaximal = (differentLetters > 0) || startsDocument(left);
+        if((length > 0) && leftMaximal && (reported.empty() || (reported.back() != length))) {
+            reported.push_back(length);
+            answer.emplace_back(suffixArray[left], length);
+        }
+
+        if(--inWindow[suffixArray.document(left)] == 0) {
+            --covered;
+        }
+        if(!minLCP.empty() && (minLCP.front() == left)) {
+            minLCP.pop_front();
+        }
+        if((left + 1 < right) && !sameLetterBefore(left)) {
+            --differentLetters;
+        }
+    }
+
+    auto longer = [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+        return a.second > b.second;
+    };
+    if(answer.size() > k) {
+        std::nth_element(answer.begin(), answer.begin() + k, answer.end(), longer);
+        answer.resize(k);
+    }
+    std::sort(answer.begin(), answer.end(), longer);
+
+    return answer;
+}
+
+
 template<typename T>
 std::pair<size_t, size_t> kCommonSubString(SuffixArray<T>& suffixArray, LCP<T>& lcp,
                                            size_t lengthOfFirstString, size_t k) {
@@ -0,0 +1,323 @@
+#ifndef GEOMETRY_GEOMETRY_H
+#define GEOMETRY_GEOMETRY_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace geometry {
+
+// Storage of coordinates. Planar and space vectors have named members, so
+// v.x, v.y, v.z work; other dimensions keep an array.
+template<typename Scalar, size_t Dimension>
+struct VectorData {
+    std::array<Scalar, Dimension> coordinates{};
+
+    Scalar& operator[](size_t i) {
+        return coordinates[i];
+    }
+    const Scalar& operator[](size_t i) const {
+        return coordinates[i];
+    }
+};
+
+template<typename Scalar>
+struct VectorData<Scalar, 2> {
+    Scalar x = 0;
+    Scalar y = 0;
+
+    Scalar& operator[](size_t i) {
+        return (i == 0) ? x : y;
+    }
+    const Scalar& operator[](size_t i) const {
+        return (i == 0) ? x : y;
+    }
+};
+
+template<typename Scalar>
+struct VectorData<Scalar, 3> {
+    Scalar x = 0;
+    Scalar y = 0;
+    Scalar z = 0;
+
+    Scalar& operator[](size_t i) {
+        return (i == 0) ? x : ((i == 1) ? y : z);
+    }
+    const Scalar& operator[](size_t i) const {
+        return (i == 0) ? x : ((i == 1) ? y : z);
+    }
+};
+
+
+template<typename Scalar, size_t Dimension>
+struct Vector: VectorData<Scalar, Dimension> {
+public:
+    using ScalarType = Scalar;
+    static const size_t kDimension = Dimension;
+
+    Vector() = default;
+
+    template<typename... Coordinates, typename = std::enable_if_t<sizeof...(Coordinates) == Dimension>>
+    Vector(Coordinates... coordinates) {
+        Scalar values[] = {static_cast<Scalar>(coordinates)...};
+        for(size_t i = 0; i < Dimension; ++i) {
+            (*this)[i] = values[i];
+        }
+    }
+
+    Scalar dot(const Vector& b) const {
+        Scalar result = 0;
+        for(size_t i = 0; i < Dimension; ++i) {
+            result += (*this)[i] * b[i];
+        }
+        return result;
+    }
+
+    // Pseudo-scalar product on the plane, vector product in space.
+    auto cross(const Vector& b) const {
+        static_assert((Dimension == 2) || (Dimension == 3), "cross is defined in 2D and 3D");
+        if constexpr(Dimension == 2) {
+            return this->x * b.y - this->y * b.x;
+        }
+        else {
+            return Vector(this->y * b.z - this->z * b.y, this->z * b.x - this->x * b.z,
+                          this->x * b.y - this->y * b.x);
+        }
+    }
+
+    Scalar triple(const Vector& b, const Vector& c) const {
+        static_assert(Dimension == 3, "triple is defined in 3D");
+        return dot(b.cross(c));
+    }
+
+    Scalar abs() const {
+        return std::sqrt(dot(*this));
+    }
+};
+
+template<typename Scalar, size_t Dimension>
+Vector<Scalar, Dimension> operator+(Vector<Scalar, Dimension> a, const Vector<Scalar, Dimension>& b) {
+    for(size_t i = 0; i < Dimension; ++i) {
+        a[i] += b[i];
+    }
+    return a;
+}
+
+template<typename Scalar, size_t Dimension>
+Vector<Scalar, Dimension> operator-(Vector<Scalar, Dimension> a) {
+    for(size_t i = 0; i < Dimension; ++i) {
+        a[i] = -a[i];
+    }
+    return a;
+}
+
+template<typename Scalar, size_t Dimension>
+Vector<Scalar, Dimension> operator-(Vector<Scalar, Dimension> a, const Vector<Scalar, Dimension>& b) {
+    for(size_t i = 0; i < Dimension; ++i) {
+        a[i] -= b[i];
+    }
+    return a;
+}
+
+template<typename Scalar, size_t Dimension>
+Vector<Scalar, Dimension> operator*(Vector<Scalar, Dimension> a, typename std::common_type<Scalar>::type b) {
+    for(size_t i = 0; i < Dimension; ++i) {
+        a[i] *= b;
+    }
+    return a;
+}
+
+template<typename Scalar, size_t Dimension>
+Vector<Scalar, Dimension> operator/(Vector<Scalar, Dimension> a, typename std::common_type<Scalar>::type b) {
+    for(size_t i = 0; i < Dimension; ++i) {
+        a[i] /= b;
+    }
+    return a;
+}
+
+template<typename Scalar, size_t Dimension>
+bool operator==(const Vector<Scalar, Dimension>& a, const Vector<Scalar, Dimension>& b) {
+    for(size_t i = 0; i < Dimension; ++i) {
+        if(a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Scalar, size_t Dimension>
+bool operator!=(const Vector<Scalar, Dimension>& a, const Vector<Scalar, Dimension>& b) {
+    return !(a == b);
+}
+
+
+// Exact sum of doubles as a nonoverlapping expansion, components go by
+// increasing magnitude and the last one has the sign of the sum
+// (Shewchuk, "Adaptive Precision Floating-Point Arithmetic").
+class Expansion {
+public:
+    Expansion() = default;
+    Expansion(double value) {
+        if(value != 0) {
+            components.push_back(value);
+        }
+    }
+
+    // a - b without rounding.
+    static Expansion difference(double a, double b) {
+        double x = a - b;
+        double bv = a - x;
+        double av = x + bv;
+        double y = (a - av) + (bv - b);
+        Expansion result;
+        for(auto c: {y, x}) {
+            if(c != 0) {
+                result.components.push_back(c);
+            }
+        }
+        return result;
+    }
+
+    Expansion& operator+=(double b) {
+        std::vector<double> result;
+        result.reserve(components.size() + 1);
+        double q = b;
+        for(auto e: components) {
+            double x = q + e;
+            double bv = x - q;
+            double av = x - bv;
+            double y = (q - av) + (e - bv);
+            if(y != 0) {
+                result.push_back(y);
+            }
+            q = x;
+        }
+        if(q != 0) {
+            result.push_back(q);
+        }
+        components = std::move(result);
+        return *this;
+    }
+
+    Expansion& operator+=(const Expansion& b) {
+        for(auto e: b.components) {
+            *this += e;
+        }
+        return *this;
+    }
+
+    Expansion operator-() const {
+        Expansion result = *this;
+        for(auto& e: result.components) {
+            e = -e;
+        }
+        return result;
+    }
+
+    friend Expansion operator+(Expansion a, const Expansion& b) {
+        return a += b;
+    }
+
+    friend Expansion operator-(Expansion a, const Expansion& b) {
+        return a += -b;
+    }
+
+    friend Expansion operator*(const Expansion& a, const Expansion& b) {
+        Expansion result;
+        for(auto x: a.components) {
+            for(auto y: b.components) {
+                double high = x * y;
+                double low = std::fma(x, y, -high);
+                result += low;
+                result += high;
+            }
+        }
+        return result;
+    }
+
+    int sign() const {
+        return components.empty() ? 0 : ((components.back() > 0) ? 1 : -1);
+    }
+
+private:
+    std::vector<double> components;
+};
+
+
+// Orientation tests, positive for counterclockwise order:
+// orient2d(a, b, c) is the sign of (b - a) x (c - a),
+// orient3d(a, b, c, d) is the sign of (a - d) . ((b - d) x (c - d)).
+// FastPredicates use plain Scalar arithmetic; ExactPredicates filter by
+// the error bound of double arithmetic and only fall back to expansions
+// when the sign is uncertain, so degenerate inputs get the true sign.
+struct FastPredicates {
+    template<typename Scalar>
+    static int orient2d(const Vector<Scalar, 2>& a, const Vector<Scalar, 2>& b, const Vector<Scalar, 2>& c) {
+        Scalar det = (b - a).cross(c - a);
+        return (det > 0) - (det < 0);
+    }
+
+    template<typename Scalar>
+    static int orient3d(const Vector<Scalar, 3>& a, const Vector<Scalar, 3>& b, const Vector<Scalar, 3>& c,
+                        const Vector<Scalar, 3>& d) {
+        Scalar det = (a - d).triple(b - d, c - d);
+        return (det > 0) - (det < 0);
+    }
+};
+
+struct ExactPredicates {
+    template<typename Scalar>
+    static int orient2d(const Vector<Scalar, 2>& a, const Vector<Scalar, 2>& b, const Vector<Scalar, 2>& c) {
+        double detLeft = (double(a.x) - c.x) * (double(b.y) - c.y);
+        double detRight = (double(a.y) - c.y) * (double(b.x) - c.x);
+        double det = detLeft - detRight;
+        double bound = kOrient2dBound * (std::abs(detLeft) + std::abs(detRight));
+        if((det > bound) || (-det > bound)) {
+            return (det > 0) ? 1 : -1;
+        }
+
+        Expansion acx = Expansion::difference(a.x, c.x), acy = Expansion::difference(a.y, c.y);
+        Expansion bcx = Expansion::difference(b.x, c.x), bcy = Expansion::difference(b.y, c.y);
+        return (acx * bcy - acy * bcx).sign();
+    }
+
+    template<typename Scalar>
+    static int orient3d(const Vector<Scalar, 3>& a, const Vector<Scalar, 3>& b, const Vector<Scalar, 3>& c,
+                        const Vector<Scalar, 3>& d) {
+        double adx = double(a.x) - d.x, ady = double(a.y) - d.y, adz = double(a.z) - d.z;
+        double bdx = double(b.x) - d.x, bdy = double(b.y) - d.y, bdz = double(b.z) - d.z;
+        double cdx = double(c.x) - d.x, cdy = double(c.y) - d.y, cdz = double(c.z) - d.z;
+
+        double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+        double cdxady = cdx * ady, adxcdy = adx * cdy;
+        double adxbdy = adx * bdy, bdxady = bdx * ady;
+        double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+        double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz) +
+                           (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz) +
+                           (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+        double bound = kOrient3dBound * permanent;
+        if((det > bound) || (-det > bound)) {
+            return (det > 0) ? 1 : -1;
+        }
+
+        Expansion eadx = Expansion::difference(a.x, d.x), eady = Expansion::difference(a.y, d.y);
+        Expansion eadz = Expansion::difference(a.z, d.z), ebdx = Expansion::difference(b.x, d.x);
+        Expansion ebdy = Expansion::difference(b.y, d.y), ebdz = Expansion::difference(b.z, d.z);
+        Expansion ecdx = Expansion::difference(c.x, d.x), ecdy = Expansion::difference(c.y, d.y);
+        Expansion ecdz = Expansion::difference(c.z, d.z);
+        Expansion exact = eadz * (ebdx * ecdy - ecdx * ebdy) + ebdz * (ecdx * eady - eadx * ecdy) +
+                          ecdz * (eadx * ebdy - ebdx * eady);
+        return exact.sign();
+    }
+
+private:
+    static constexpr double kEpsilon = 1.1102230246251565e-16;
+    static constexpr double kOrient2dBound = (3.0 + 16.0 * kEpsilon) * kEpsilon;
+    static constexpr double kOrient3dBound = (7.0 + 56.0 * kEpsilon) * kEpsilon;
+};
+
+}  // namespace geometry
+
+#endif //GEOMETRY_GEOMETRY_H
@@ -5,76 +5,43 @@
 #include <iomanip>
 #include <algorithm>
 #include <limits>
+#include <vector>
+#include <queue>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
 
+#include "geometry.h"
 
-struct Vector {
-public:
-    Vector(): x(0), y(0), z(0)
-    {}
-    Vector(const Vector& v) = default;
-    Vector(Vector&& v) noexcept = default;
-    Vector& operator=(const Vector& v) = default;
-    Vector& operator=(Vector&& v) noexcept = default;
-
-    Vector(double _x, double _y, double _z): x(_x), y(_y), z(_z)
-    {}
-
-    double dot(Vector b) const {
-        return x * b.x + y * b.y + z * b.z;
-    }
-    Vector cross(Vector b) const {
-        return Vector( y * b.z - z * b.y, z * b.x - x * b.z, x * b.y - y * b.x);
-    }
-    double triple(Vector b, Vector c) const {
-        return dot(b.cross(c));
-    }
-    double abs() const {
-        return std::sqrt(x * x + y * y + z * z);
-    }
-
-    double x;
-    double y;
-    double z;
-};
-
-Vector operator+(Vector a, Vector b) {
-    return Vector(a.x + b.x, a.y + b.y, a.z + b.z);
-}
 
-Vector operator-(Vector a) {
-    return Vector(-a.x, -a.y, -a.z);
-}
-
-Vector operator-(Vector a, Vector b) {
-    return Vector(a.x - b.x, a.y - b.y, a.z - b.z);
-}
-
-Vector operator*(Vector a, double b) {
-    return Vector(a.x * b, a.y * b, a.z * b);
-}
-
-Vector operator/(Vector a, double b) {
-    return Vector(a.x / b, a.y / b, a.z / b);
-}
+using Vector = geometry::Vector<double, 3>;
 
 
 class Segment{
 public:
-    Segment(Vector& begin, Vector& end): begin(begin), end(end)
+    Segment(const Vector& begin, const Vector& end): begin(begin), end(end)
     {}
 
-    static double closetDistance(Segment seg1, Segment seg2, double epsilon) {
-        double a = seg1.direction().dot(seg1.direction());
-        double b = seg1.direction().dot(seg2.direction());
-        double c = seg2.direction().dot(seg2.direction());
-        double d = seg1.direction().dot((seg1.begin - seg2.begin));
-        double e = seg2.direction().dot((seg1.begin - seg2.begin));
+    static double closetDistance(const Segment& seg1, const Segment& seg2, double epsilon) {
+        Vector u = seg1.direction();
+        Vector v = seg2.direction();
+        Vector w = seg1.begin - seg2.begin;
+        double a = u.dot(u);
+        double b = u.dot(v);
+        double c = v.dot(v);
+        double d = u.dot(w);
+        double e = v.dot(w);
 
+        // D = a * c * sin^2 of the angle, the parallel test is relative to
+        // a * c so that it does not depend on the lengths.
         double D = a * c - b * b;
         double sc, sN, sD = D;
         double tc, tN, tD = D;
 
-        if(D <= epsilon) {
+        if(D <= epsilon * a * c) {
             sN = 0;
             sD = 1;
             tN = e;
@@ -122,15 +89,17 @@ public:
             }
         }
 
-        sc = (std::abs(sN) <= epsilon ? 0 : sN / sD);
-        tc = (std::abs(tN) <= epsilon ? 0 : tN / tD);
+        // Parameters below epsilon snap to the segment begins, sN and sD
+        // scale with the fourth power of the lengths, so the test is relative.
+        sc = (std::abs(sN) <= epsilon * sD ? 0 : sN / sD);
+        tc = (std::abs(tN) <= epsilon * tD ? 0 : tN / tD);
 
-        Vector dP = seg1.begin - seg2.begin + seg1.direction() * sc - seg2.direction() * tc;
+        Vector dP = w + u * sc - v * tc;
 
         return dP.abs();
     }
 
-    Vector direction() {
+    Vector direction() const {
         return end - begin;
     }
 
@@ -139,6 +108,560 @@ public:
 };
 
 
+template<typename Scalar>
+inline std::enable_if_t<std::is_floating_point_v<Scalar>, Scalar> select(bool mask, Scalar a, Scalar b) {
+    return mask ? a : b;
+}
+
+// The same computation as Segment::closetDistance without branches: every
+// "if" becomes a select, so it runs on several pairs at once. Lanes is double
+// or a SIMD register wrapper below. Pairs with D <= parallelEpsilon * a * c
+// are parallel, the scalar code uses epsilon there.
+template<typename Lanes>
+Lanes closetDistanceLanes(const Lanes u[3], const Lanes v[3], const Lanes w[3], double epsilon,
+                          double parallelEpsilon) {
+    using std::abs;
+    using std::sqrt;
+    Lanes zero(0.0), one(1.0), eps(epsilon), parallelEps(parallelEpsilon);
+
+    Lanes a = u[0] * u[0] + u[1] * u[1] + u[2] * u[2];
+    Lanes b = u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+    Lanes c = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+    Lanes d = u[0] * w[0] + u[1] * w[1] + u[2] * w[2];
+    Lanes e = v[0] * w[0] + v[1] * w[1] + v[2] * w[2];
+
+    Lanes D = a * c - b * b;
+    auto parallel = D <= parallelEps * a * c;
+
+    Lanes sN = b * e - c * d, sD = D;
+    Lanes tN = a * e - b * d, tD = D;
+    auto sLow = sN <= zero;
+    auto sHigh = (!sLow) & (sN >= sD);
+    tN = select(sLow, e, select(sHigh, e + b, tN));
+    tD = select(sLow | sHigh, c, tD);
+    sN = select(sLow, zero, select(sHigh, sD, sN));
+
+    sN = select(parallel, zero, sN);
+    sD = select(parallel, one, sD);
+    tN = select(parallel, e, tN);
+    tD = select(parallel, c, tD);
+
+    // Clamp t to [0, 1] and recompute s for the clamped end.
+    auto tLow = tN <= zero;
+    auto tHigh = (!tLow) & (tN >= tD);
+    Lanes r = select(tLow, zero - d, b - d);
+    auto rLow = r <= zero;
+    auto rHigh = (!rLow) & (r >= a);
+    auto clamped = tLow | tHigh;
+    sN = select(clamped, select(rLow, zero, select(rHigh, sD, r)), sN);
+    sD = select(clamped & !(rLow | rHigh), a, sD);
+    tN = select(tLow, zero, select(tHigh, tD, tN));
+
+    Lanes sc = select(abs(sN) <= eps * sD, zero, sN / sD);
+    Lanes tc = select(abs(tN) <= eps * tD, zero, tN / tD);
+
+    Lanes dx = w[0] + u[0] * sc - v[0] * tc;
+    Lanes dy = w[1] + u[1] * sc - v[1] * tc;
+    Lanes dz = w[2] + u[2] * sc - v[2] * tc;
+
+    return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+#ifdef __AVX__
+struct Mask4 {
+    __m256d value;
+};
+
+Mask4 operator&(Mask4 a, Mask4 b) {
+    return {_mm256_and_pd(a.value, b.value)};
+}
+
+Mask4 operator|(Mask4 a, Mask4 b) {
+    return {_mm256_or_pd(a.value, b.value)};
+}
+
+Mask4 operator!(Mask4 a) {
+    return {_mm256_xor_pd(a.value, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)))};
+}
+
+// Four doubles in one AVX register.
+struct Double4 {
+    static const size_t kLanes = 4;
+
+    Double4(double x): value(_mm256_set1_pd(x))
+    {}
+    explicit Double4(__m256d v): value(v)
+    {}
+
+    static Double4 load(const double* p) {
+        return Double4(_mm256_loadu_pd(p));
+    }
+    void store(double* p) const {
+        _mm256_storeu_pd(p, value);
+    }
+
+    __m256d value;
+};
+
+Double4 operator+(Double4 a, Double4 b) {
+    return Double4(_mm256_add_pd(a.value, b.value));
+}
+
+Double4 operator-(Double4 a, Double4 b) {
+    return Double4(_mm256_sub_pd(a.value, b.value));
+}
+
+Double4 operator*(Double4 a, Double4 b) {
+    return Double4(_mm256_mul_pd(a.value, b.value));
+}
+
+Double4 operator/(Double4 a, Double4 b) {
+    return Double4(_mm256_div_pd(a.value, b.value));
+}
+
+Mask4 operator<=(Double4 a, Double4 b) {
+    return {_mm256_cmp_pd(a.value, b.value, _CMP_LE_OQ)};
+}
+
+Mask4 operator>=(Double4 a, Double4 b) {
+    return {_mm256_cmp_pd(a.value, b.value, _CMP_GE_OQ)};
+}
+
+Double4 select(Mask4 mask, Double4 a, Double4 b) {
+    return Double4(_mm256_blendv_pd(b.value, a.value, mask.value));
+}
+
+Double4 abs(Double4 a) {
+    return Double4(_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.value));
+}
+
+Double4 sqrt(Double4 a) {
+    return Double4(_mm256_sqrt_pd(a.value));
+}
+
+struct Mask8f {
+    __m256 value;
+};
+
+Mask8f operator&(Mask8f a, Mask8f b) {
+    return {_mm256_and_ps(a.value, b.value)};
+}
+
+Mask8f operator|(Mask8f a, Mask8f b) {
+    return {_mm256_or_ps(a.value, b.value)};
+}
+
+Mask8f operator!(Mask8f a) {
+    return {_mm256_xor_ps(a.value, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))};
+}
+
+// Eight floats in one AVX register: twice as many pairs as Double4.
+struct Float8 {
+    static const size_t kLanes = 8;
+
+    Float8(float x): value(_mm256_set1_ps(x))
+    {}
+    explicit Float8(__m256 v): value(v)
+    {}
+
+    static Float8 load(const float* p) {
+        return Float8(_mm256_loadu_ps(p));
+    }
+    void store(float* p) const {
+        _mm256_storeu_ps(p, value);
+    }
+
+    __m256 value;
+};
+
+Float8 operator+(Float8 a, Float8 b) {
+    return Float8(_mm256_add_ps(a.value, b.value));
+}
+
+Float8 operator-(Float8 a, Float8 b) {
+    return Float8(_mm256_sub_ps(a.value, b.value));
+}
+
+Float8 operator*(Float8 a, Float8 b) {
+    return Float8(_mm256_mul_ps(a.value, b.value));
+}
+
+Float8 operator/(Float8 a, Float8 b) {
+    return Float8(_mm256_div_ps(a.value, b.value));
+}
+
+Mask8f operator<=(Float8 a, Float8 b) {
+    return {_mm256_cmp_ps(a.value, b.value, _CMP_LE_OQ)};
+}
+
+Mask8f operator>=(Float8 a, Float8 b) {
+    return {_mm256_cmp_ps(a.value, b.value, _CMP_GE_OQ)};
+}
+
+Float8 select(Mask8f mask, Float8 a, Float8 b) {
+    return Float8(_mm256_blendv_ps(b.value, a.value, mask.value));
+}
+
+Float8 abs(Float8 a) {
+    return Float8(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.value));
+}
+
+Float8 sqrt(Float8 a) {
+    return Float8(_mm256_sqrt_ps(a.value));
+}
+#endif
+
+#ifdef __AVX512F__
+// Eight doubles in one AVX-512 register, comparisons give bit masks.
+struct Double8 {
+    static const size_t kLanes = 8;
+
+    Double8(double x): value(_mm512_set1_pd(x))
+    {}
+    explicit Double8(__m512d v): value(v)
+    {}
+
+    static Double8 load(const double* p) {
+        return Double8(_mm512_loadu_pd(p));
+    }
+    void store(double* p) const {
+        _mm512_storeu_pd(p, value);
+    }
+
+    __m512d value;
+};
+
+struct Mask8 {
+    __mmask8 value;
+};
+
+Mask8 operator&(Mask8 a, Mask8 b) {
+    return {static_cast<__mmask8>(a.value & b.value)};
+}
+
+Mask8 operator|(Mask8 a, Mask8 b) {
+    return {static_cast<__mmask8>(a.value | b.value)};
+}
+
+Mask8 operator!(Mask8 a) {
+    return {static_cast<__mmask8>(~a.value)};
+}
+
+Double8 operator+(Double8 a, Double8 b) {
+    return Double8(_mm512_add_pd(a.value, b.value));
+}
+
+Double8 operator-(Double8 a, Double8 b) {
+    return Double8(_mm512_sub_pd(a.value, b.value));
+}
+
+Double8 operator*(Double8 a, Double8 b) {
+    return Double8(_mm512_mul_pd(a.value, b.value));
+}
+
+Double8 operator/(Double8 a, Double8 b) {
+    return Double8(_mm512_div_pd(a.value, b.value));
+}
+
+Mask8 operator<=(Double8 a, Double8 b) {
+    return {_mm512_cmp_pd_mask(a.value, b.value, _CMP_LE_OQ)};
+}
+
+Mask8 operator>=(Double8 a, Double8 b) {
+    return {_mm512_cmp_pd_mask(a.value, b.value, _CMP_GE_OQ)};
+}
+
+Double8 select(Mask8 mask, Double8 a, Double8 b) {
+    return Double8(_mm512_mask_blend_pd(mask.value, b.value, a.value));
+}
+
+Double8 abs(Double8 a) {
+    return Double8(_mm512_abs_pd(a.value));
+}
+
+Double8 sqrt(Double8 a) {
+    return Double8(_mm512_sqrt_pd(a.value));
+}
+#endif
+
+
+// Segments as structure of arrays: begins and directions by coordinates.
+// SegmentBatch<float> halves the memory traffic and doubles the SIMD width.
+template<typename Scalar = double>
+class SegmentBatch {
+public:
+    void reserve(size_t size) {
+        for(auto coordinate: {&beginX, &beginY, &beginZ, &directionX, &directionY, &directionZ}) {
+            coordinate->reserve(size);
+        }
+    }
+
+    void add(const Segment& segment) {
+        Vector direction = segment.direction();
+        beginX.push_back(segment.begin.x);
+        beginY.push_back(segment.begin.y);
+        beginZ.push_back(segment.begin.z);
+        directionX.push_back(direction.x);
+        directionY.push_back(direction.y);
+        directionZ.push_back(direction.z);
+    }
+
+    size_t size() const {
+        return beginX.size();
+    }
+
+    // result[i] is the distance between i-th segments of first and second,
+    // pairs go by 8 (AVX-512 double, AVX float) or 4 (AVX double) at once,
+    // the rest one by one.
+    // Results equal the scalar ones when built with -ffp-contract=off; with
+    // FMA contraction they agree within rounding, the parallel test is
+    // relative, so rounding of D does not move a pair between branches.
+    static void closetDistance(const SegmentBatch& first, const SegmentBatch& second, double epsilon,
+                               Scalar* result) {
+        size_t size = std::min(first.size(), second.size());
+        double parallelEpsilon = std::max(epsilon, kParallelEpsilon);
+        size_t i = 0;
+        if constexpr(std::is_same_v<Scalar, double>) {
+#ifdef __AVX512F__
+            i = m_closetDistanceBlocks<Double8>(first, second, epsilon, parallelEpsilon, result, i, size);
+#endif
+#ifdef __AVX__
+            i = m_closetDistanceBlocks<Double4>(first, second, epsilon, parallelEpsilon, result, i, size);
+#endif
+        }
+        else {
+#ifdef __AVX__
+            i = m_closetDistanceBlocks<Float8>(first, second, epsilon, parallelEpsilon, result, i, size);
+#endif
+        }
+        for(; i < size; ++i) {
+            Scalar u[3] = {first.directionX[i], first.directionY[i], first.directionZ[i]};
+            Scalar v[3] = {second.directionX[i], second.directionY[i], second.directionZ[i]};
+            Scalar w[3] = {first.beginX[i] - second.beginX[i], first.beginY[i] - second.beginY[i],
+                           first.beginZ[i] - second.beginZ[i]};
+            result[i] = closetDistanceLanes(u, v, w, epsilon, parallelEpsilon);
+        }
+    }
+
+private:
+    // D is rounded to a few units in the last place of a * c; for double
+    // that is far below any sensible epsilon, for float it is not, and
+    // parallel pairs would fall into the other branch.
+    static constexpr double kParallelEpsilon = 16 * std::numeric_limits<Scalar>::epsilon();
+
+    std::vector<Scalar> beginX;
+    std::vector<Scalar> beginY;
+    std::vector<Scalar> beginZ;
+    std::vector<Scalar> directionX;
+    std::vector<Scalar> directionY;
+    std::vector<Scalar> directionZ;
+
+    template<typename Lanes>
+    static size_t m_closetDistanceBlocks(const SegmentBatch& first, const SegmentBatch& second, double epsilon,
+                                         double parallelEpsilon, Scalar* result, size_t i, size_t size) {
+        for(; i + Lanes::kLanes <= size; i += Lanes::kLanes) {
+            Lanes u[3] = {Lanes::load(&first.directionX[i]), Lanes::load(&first.directionY[i]),
+                          Lanes::load(&first.directionZ[i])};
+            Lanes v[3] = {Lanes::load(&second.directionX[i]), Lanes::load(&second.directionY[i]),
+                          Lanes::load(&second.directionZ[i])};
+            Lanes w[3] = {Lanes::load(&first.beginX[i]) - Lanes::load(&second.beginX[i]),
+                          Lanes::load(&first.beginY[i]) - Lanes::load(&second.beginY[i]),
+                          Lanes::load(&first.beginZ[i]) - Lanes::load(&second.beginZ[i])};
+            closetDistanceLanes(u, v, w, epsilon, parallelEpsilon).store(result + i);
+        }
+        return i;
+    }
+};
+
+
+// Bounding volume hierarchy over boxes of a static set of segments. The
+// distance between the box of a query and the box of a node bounds the
+// distance to every segment below, closetDistance is the exact leaf test.
+class SegmentBVH {
+public:
+    using Neighbour = std::pair<size_t, double>;
+
+    explicit SegmentBVH(const std::vector<Segment>& _segments, double epsilon = 1e-10):
+        epsilon(epsilon), order(_segments.size()) {
+        std::iota(order.begin(), order.end(), 0);
+        segments.reserve(_segments.size());
+        if(!_segments.empty()) {
+            nodes.reserve(4 * _segments.size() / kLeafSize + 1);
+            nodes.resize(1);
+            m_build(_segments, 0, _segments.size(), 0);
+        }
+        for(auto i: order) {
+            segments.push_back(_segments[i]);
+        }
+    }
+
+    // k closest segments as (index, distance), the closest first.
+    std::vector<Neighbour> nearest(const Segment& query, size_t k = 1) const {
+        std::vector<Neighbour> best;
+        if(nodes.empty() || (k == 0)) {
+            return best;
+        }
+
+        Box box = m_boxOf(query);
+        auto farther = [](const Neighbour& a, const Neighbour& b) { return a.second < b.second; };
+        auto bound = [&best, k]() {
+            return (best.size() < k) ? std::numeric_limits<double>::infinity() : best.front().second;
+        };
+
+        using Candidate = std::pair<double, size_t>;
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+        queue.emplace(m_distance(box, nodes[0].box), 0);
+        while(!queue.empty() && (queue.top().first <= bound())) {
+            auto& node = nodes[queue.top().second];
+            queue.pop();
+            if(node.count > 0) {
+                for(size_t i = node.first; i < node.first + node.count; ++i) {
+                    double distance = Segment::closetDistance(query, segments[i], epsilon);
+                    if(distance < bound()) {
+                        if(best.size() == k) {
+                            std::pop_heap(best.begin(), best.end(), farther);
+                            best.pop_back();
+                        }
+                        best.emplace_back(order[i], distance);
+                        std::push_heap(best.begin(), best.end(), farther);
+                    }
+                }
+                continue;
+            }
+            for(auto child: {node.first, node.first + 1}) {
+                double distance = m_distance(box, nodes[child].box);
+                if(distance <= bound()) {
+                    queue.emplace(distance, child);
+                }
+            }
+        }
+
+        std::sort_heap(best.begin(), best.end(), farther);
+        return best;
+    }
+
+    // All segments not farther than radius, in no particular order.
+    std::vector<Neighbour> within(const Segment& query, double radius) const {
+        std::vector<Neighbour> answer;
+        if(nodes.empty()) {
+            return answer;
+        }
+
+        Box box = m_boxOf(query);
+        std::vector<size_t> stack = {0};
+        while(!stack.empty()) {
+            auto& node = nodes[stack.back()];
+            stack.pop_back();
+            if(m_distance(box, node.box) > radius) {
+                continue;
+            }
+            if(node.count > 0) {
+                for(size_t i = node.first; i < node.first + node.count; ++i) {
+                    double distance = Segment::closetDistance(query, segments[i], epsilon);
+                    if(distance <= radius) {
+                        answer.emplace_back(order[i], distance);
+                    }
+                }
+            }
+            else {
+                stack.push_back(node.first);
+                stack.push_back(node.first + 1);
+            }
+        }
+
+        return answer;
+    }
+
+    // nearest(queries[i], k) for all queries, split between threads.
+    std::vector<std::vector<Neighbour>> nearest(const std::vector<Segment>& queries, size_t k,
+                                                size_t threads = std::thread::hardware_concurrency()) const {
+        std::vector<std::vector<Neighbour>> answer(queries.size());
+        threads = std::max<size_t>(1, std::min(threads, queries.size()));
+        std::vector<std::thread> workers;
+        for(size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                for(size_t i = t * queries.size() / threads; i < (t + 1) * queries.size() / threads; ++i) {
+                    answer[i] = nearest(queries[i], k);
+                }
+            });
+        }
+        for(auto& worker: workers) {
+            worker.join();
+        }
+        return answer;
+    }
+
+private:
+    struct Box {
+        Vector min;
+        Vector max;
+    };
+
+    // Leaf keeps segments [first, first + count), inner node has count = 0
+    // and children first and first + 1.
+    struct Node {
+        Box box;
+        size_t first;
+        size_t count;
+    };
+
+    static const size_t kLeafSize = 4;
+
+    double epsilon;
+    std::vector<size_t> order;
+    std::vector<Segment> segments;
+    std::vector<Node> nodes;
+
+    static Box m_boxOf(const Segment& segment) {
+        return {Vector(std::min(segment.begin.x, segment.end.x), std::min(segment.begin.y, segment.end.y),
+                       std::min(segment.begin.z, segment.end.z)),
+                Vector(std::max(segment.begin.x, segment.end.x), std::max(segment.begin.y, segment.end.y),
+                       std::max(segment.begin.z, segment.end.z))};
+    }
+
+    static Box m_merge(const Box& a, const Box& b) {
+        return {Vector(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)),
+                Vector(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z))};
+    }
+
+    static double m_distance(const Box& a, const Box& b) {
+        double dx = std::max({0.0, a.min.x - b.max.x, b.min.x - a.max.x});
+        double dy = std::max({0.0, a.min.y - b.max.y, b.min.y - a.max.y});
+        double dz = std::max({0.0, a.min.z - b.max.z, b.min.z - a.max.z});
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    // Fills node id from order[begin, end), splitting by the median of centers
+    // along the longest axis. Children of a node are stored next to each other.
+    void m_build(const std::vector<Segment>& source, size_t begin, size_t end, size_t id) {
+        Box box = m_boxOf(source[order[begin]]);
+        for(size_t i = begin + 1; i < end; ++i) {
+            box = m_merge(box, m_boxOf(source[order[i]]));
+        }
+        nodes[id] = {box, begin, end - begin};
+        if(end - begin <= kLeafSize) {
+            return;
+        }
+
+        Vector size = box.max - box.min;
+        double Vector::* axis = (size.x >= size.y) ? ((size.x >= size.z) ? &Vector::x : &Vector::z)
+                                                   : ((size.y >= size.z) ? &Vector::y : &Vector::z);
+        size_t middle = (begin + end) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                         [&source, axis](size_t a, size_t b) {
+            return source[a].begin.*axis + source[a].end.*axis < source[b].begin.*axis + source[b].end.*axis;
+        });
+
+        size_t children = nodes.size();
+        nodes.resize(children + 2);
+        nodes[id].first = children;
+        nodes[id].count = 0;
+        m_build(source, begin, middle, children);
+        m_build(source, middle, end, children + 1);
+    }
+};
+
+
 int main() {
     std::array<Vector, 4> points;
     for(int i = 0; i < 4; ++i) {
@@ -3,60 +3,23 @@
 #include <algorithm>
 #include <set>
 #include <queue>
+#include <numeric>
+#include <random>
+#include <thread>
 #include <vector>
+#include <utility>
 #include <iostream>
 
-struct Vector {
-public:
-    Vector(): x(0), y(0), z(0)
-    {}
-    Vector(const Vector& v) = default;
-    Vector(Vector&& v) noexcept = default;
-    Vector& operator=(const Vector& v) = default;
-    Vector& operator=(Vector&& v) noexcept = default;
-
-    Vector(double _x, double _y, double _z): x(_x), y(_y), z(_z)
-    {}
-
-    double dot(Vector b) const {
-        return x * b.x + y * b.y + z * b.z;
-    }
-    Vector cross(Vector b) const {
-        return Vector( y * b.z - z * b.y, z * b.x - x * b.z, x * b.y - y * b.x);
-    }
-    double triple(Vector b, Vector c) const {
-        return dot(b.cross(c));
-    }
-    double abs() const {
-        return std::sqrt(x * x + y * y + z * z);
-    }
+#include "geometry.h"
 
-    double x;
-    double y;
-    double z;
-};
 
-Vector operator+(Vector a, Vector b) {
-    return Vector(a.x + b.x, a.y + b.y, a.z + b.z);
-}
-
-Vector operator-(Vector a) {
-    return Vector(-a.x, -a.y, -a.z);
-}
-
-Vector operator-(Vector a, Vector b) {
-    return Vector(a.x - b.x, a.y - b.y, a.z - b.z);
-}
-
-Vector operator*(Vector a, double b) {
-    return Vector(a.x * b, a.y * b, a.z * b);
-}
-
-Vector operator/(Vector a, double b) {
-    return Vector(a.x / b, a.y / b, a.z / b);
-}
+using Vector = geometry::Vector<double, 3>;
 
 
+// Predicates decide orientation of four points: geometry::FastPredicates
+// are plain double arithmetic, geometry::ExactPredicates stay correct on
+// coplanar and nearly coplanar points at some cost in speed.
+template<typename Predicates = geometry::FastPredicates>
 class GiftWrap {
 public:
     GiftWrap() = default;
@@ -124,9 +87,7 @@ private:
             if(i == edge[0] || i == edge[1]) {
                 continue;
             }
-            double volume = (points[i] - points[edge[0]]).triple(points[edge[1]] - points[edge[0]],
-                    points[p] - points[edge[0]]);
-            if(volume > 0) {
+            if(Predicates::orient3d(points[i], points[edge[1]], points[p], points[edge[0]]) > 0) {
                 p = i;
             }
         }
@@ -172,8 +133,7 @@ private:
     }
 
     std::array<size_t, 3> m_makeRightTriangle(std::array<size_t, 3> triangle) {
-        Vector d = iternalPoint - points[triangle[0]];
-        if(d.triple(points[triangle[1]] - points[triangle[0]], points[triangle[2]] - points[triangle[0]]) > 0) {
+        if(Predicates::orient3d(iternalPoint, points[triangle[1]], points[triangle[2]], points[triangle[0]]) > 0) {
             std::reverse(triangle.begin(), triangle.end());
         }
 
@@ -189,26 +149,701 @@ private:
     }
 };
 
+
+// Randomized incremental hull with a conflict graph: every face keeps the
+// points that see it and every point one face it sees, the rest of its
+// visible region is found from there through the mesh. A point which saw
+// a removed face either sees one of the new faces or is inside the hull,
+// so a point whose face does not see it any more is skipped. Slots of
+// removed faces are reused. O(n log n) expected time.
+// Faces are triangles of a half-edge mesh: face f owns half-edges 3f, 3f + 1,
+// 3f + 2, the i-th going from vertex[i] to vertex[(i + 1) % 3], and twin
+// links the half-edge of the neighbouring face. Points on the boundary of
+// the hull but not its vertices are dropped.
+template<typename Predicates = geometry::FastPredicates>
+class IncrementalHull {
+public:
+    IncrementalHull() = default;
+    explicit IncrementalHull(const std::vector<Vector>& _points): points(_points)
+    {}
+
+    // New points for the next run, the buffers of the previous runs are reused.
+    template<typename Iterator>
+    void assign(Iterator first, Iterator last) {
+        points.assign(first, last);
+    }
+
+    void run() {
+        freeFaces.clear();
+        for(size_t face = faces.size(); face-- > 0;) {
+            m_release(face);
+        }
+        pointFace.assign(points.size(), kNone);
+        newFaceFrom.assign(points.size(), kNone);
+
+        std::array<size_t, 4> simplex;
+        if(!m_findSimplex(simplex)) {
+            return;
+        }
+
+        // Points are renumbered in the order of insertion, then conflict lists
+        // stay sorted and are scanned along the memory.
+        original.assign(simplex.begin(), simplex.end());
+        for(size_t i = 0; i < points.size(); ++i) {
+            if(std::find(simplex.begin(), simplex.end(), i) == simplex.end()) {
+                original.push_back(i);
+            }
+        }
+        std::shuffle(original.begin() + 4, original.end(), std::minstd_rand(kSeed));
+        ordered.resize(points.size());
+        for(size_t i = 0; i < points.size(); ++i) {
+            ordered[i] = points[original[i]];
+        }
+        points.swap(ordered);
+
+        m_buildSimplex();
+        for(size_t p = 4; p < points.size(); ++p) {
+            m_insert(p);
+        }
+    }
+
+    std::vector<std::array<size_t, 3>> answer() const {
+        std::vector<std::array<size_t, 3>> answer(m_maxFaces());
+        answer.resize(this->answer(answer.data()));
+        return answer;
+    }
+
+    // Writes the faces to output, which has room for 2n - 4 of them, and
+    // returns their number.
+    size_t answer(std::array<size_t, 3>* output) const {
+        size_t size = 0;
+        for(auto& face: faces) {
+            if(face.alive) {
+                auto& a = output[size++];
+                a = {original[face.vertex[0]], original[face.vertex[1]], original[face.vertex[2]]};
+                std::rotate(a.begin(), std::min_element(a.begin(), a.end()), a.end());
+            }
+        }
+        std::sort(output, output + size);
+        return size;
+    }
+private:
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+    static constexpr unsigned kSeed = 20200509;
+    // Conflict lists up to this size keep their memory in a released slot.
+    static constexpr size_t kKeptCapacity = 8;
+
+    // A point in a conflict list carries its coordinates, so scanning the
+    // list does not jump over the whole point array.
+    struct Conflict {
+        size_t point;
+        Vector position;
+    };
+
+    struct Face {
+        std::array<size_t, 3> vertex;
+        bool alive;
+        std::vector<Conflict> conflicts;
+    };
+
+    std::vector<Vector> points;
+    std::vector<Vector> ordered;
+    std::vector<size_t> original;
+    std::vector<Face> faces;
+    std::vector<size_t> twin;
+    std::vector<size_t> pointFace;
+    std::vector<size_t> newFaceFrom;
+    std::vector<size_t> visible;
+    std::vector<size_t> created;
+    std::vector<size_t> freeFaces;
+
+    size_t m_maxFaces() const {
+        return (points.size() < 4) ? 0 : 2 * points.size() - 4;
+    }
+
+    bool m_sees(size_t face, size_t p) const {
+        auto& v = faces[face].vertex;
+        return Predicates::orient3d(points[v[0]], points[v[1]], points[v[2]], points[p]) < 0;
+    }
+
+    bool m_collinear(const Vector& a, const Vector& b, const Vector& c) const {
+        using Vector2 = geometry::Vector<double, 2>;
+        return Predicates::orient2d(Vector2(a.x, a.y), Vector2(b.x, b.y), Vector2(c.x, c.y)) == 0 &&
+               Predicates::orient2d(Vector2(a.y, a.z), Vector2(b.y, b.z), Vector2(c.y, c.z)) == 0 &&
+               Predicates::orient2d(Vector2(a.z, a.x), Vector2(b.z, b.x), Vector2(c.z, c.x)) == 0;
+    }
+
+    // Four points not in one plane, the first of them is the point 0.
+    bool m_findSimplex(std::array<size_t, 4>& simplex) const {
+        size_t n = points.size(), i = 1;
+        simplex[0] = 0;
+        while(i < n && points[i] == points[0]) {
+            ++i;
+        }
+        simplex[1] = i;
+        while(i < n && m_collinear(points[0], points[simplex[1]], points[i])) {
+            ++i;
+        }
+        simplex[2] = i;
+        while(i < n && Predicates::orient3d(points[0], points[simplex[1]], points[simplex[2]], points[i]) == 0) {
+            ++i;
+        }
+        simplex[3] = i;
+        return i < n;
+    }
+
+    size_t m_addFace(size_t a, size_t b, size_t c) {
+        if(freeFaces.empty()) {
+            faces.push_back({{a, b, c}, true, {}});
+            twin.resize(twin.size() + 3, kNone);
+            return faces.size() - 1;
+        }
+        size_t face = freeFaces.back();
+        freeFaces.pop_back();
+        faces[face].vertex = {a, b, c};
+        faces[face].alive = true;
+        return face;
+    }
+
+    void m_release(size_t face) {
+        faces[face].alive = false;
+        if(faces[face].conflicts.capacity() > kKeptCapacity) {
+            std::vector<Conflict>().swap(faces[face].conflicts);
+        }
+        else {
+            faces[face].conflicts.clear();
+        }
+        freeFaces.push_back(face);
+    }
+
+    void m_addConflict(size_t face, const Conflict& conflict) {
+        faces[face].conflicts.push_back(conflict);
+        pointFace[conflict.point] = face;
+    }
+
+    // Points of the sorted lists first and second, except p, that see the face.
+    void m_mergeConflicts(size_t face, const std::vector<Conflict>& first, const std::vector<Conflict>& second,
+                          size_t p) {
+        auto& v = faces[face].vertex;
+        const Vector& a = points[v[0]];
+        const Vector& b = points[v[1]];
+        const Vector& c = points[v[2]];
+        size_t i = 0, j = 0;
+        while(i < first.size() || j < second.size()) {
+            const Conflict* q;
+            if(j == second.size() || (i < first.size() && first[i].point < second[j].point)) {
+                q = &first[i++];
+            }
+            else if(i == first.size() || second[j].point < first[i].point) {
+                q = &second[j++];
+            }
+            else {
+                q = &first[i++];
+                ++j;
+            }
+            if(q->point != p && Predicates::orient3d(a, b, c, q->position) < 0) {
+                m_addConflict(face, *q);
+            }
+        }
+    }
+
+    // Tetrahedron on the points 0..3.
+    void m_buildSimplex() {
+        std::array<size_t, 4> simplex;
+        for(size_t skip = 0; skip < 4; ++skip) {
+            std::array<size_t, 3> v;
+            for(size_t i = 0, j = 0; i < 4; ++i) {
+                if(i != skip) {
+                    v[j++] = i;
+                }
+            }
+            if(Predicates::orient3d(points[v[0]], points[v[1]], points[v[2]], points[skip]) < 0) {
+                std::swap(v[1], v[2]);
+            }
+            simplex[skip] = m_addFace(v[0], v[1], v[2]);
+        }
+        for(auto first: simplex) {
+            for(auto second: simplex) {
+                for(size_t e = 3 * first; e < 3 * first + 3; ++e) {
+                    for(size_t g = 3 * second; g < 3 * second + 3; ++g) {
+                        if(m_origin(e) == m_destination(g) && m_destination(e) == m_origin(g)) {
+                            twin[e] = g;
+                        }
+                    }
+                }
+            }
+        }
+        for(size_t p = 4; p < points.size(); ++p) {
+            for(auto face: simplex) {
+                if(m_sees(face, p)) {
+                    m_addConflict(face, {p, points[p]});
+                }
+            }
+        }
+    }
+
+    size_t m_origin(size_t edge) const {
+        return faces[edge / 3].vertex[edge % 3];
+    }
+
+    size_t m_destination(size_t edge) const {
+        return faces[edge / 3].vertex[(edge % 3 + 1) % 3];
+    }
+
+    void m_insert(size_t p) {
+        size_t start = pointFace[p];
+        if(start == kNone || !faces[start].alive || !m_sees(start, p)) {
+            return;
+        }
+        visible.assign(1, start);
+        faces[start].alive = false;
+        for(size_t i = 0; i < visible.size(); ++i) {
+            for(size_t k = 0; k < 3; ++k) {
+                size_t neighbour = twin[3 * visible[i] + k] / 3;
+                if(faces[neighbour].alive && m_sees(neighbour, p)) {
+                    faces[neighbour].alive = false;
+                    visible.push_back(neighbour);
+                }
+            }
+        }
+
+        created.clear();
+        for(auto face: visible) {
+            for(size_t k = 0; k < 3; ++k) {
+                size_t edge = 3 * face + k, outer = twin[edge];
+                if(!faces[outer / 3].alive) {
+                    continue;
+                }
+                size_t a = m_origin(edge), b = m_destination(edge);
+                size_t added = m_addFace(a, b, p);
+                created.push_back(added);
+                twin[3 * added] = outer;
+                twin[outer] = 3 * added;
+                newFaceFrom[a] = added;
+
+                m_mergeConflicts(added, faces[face].conflicts, faces[outer / 3].conflicts, p);
+            }
+        }
+        for(auto face: created) {
+            size_t next = newFaceFrom[faces[face].vertex[1]];
+            twin[3 * face + 1] = 3 * next + 2;
+            twin[3 * next + 2] = 3 * face + 1;
+        }
+        for(auto face: visible) {
+            m_release(face);
+        }
+    }
+};
+
+
+// Parallel pruning by x, not divide and conquer: the points are split in
+// halves by x while threads remain, the halves are hulled in parallel, and
+// only their vertices go on, since a point inside a part is inside the
+// whole. The halves are not stitched along the seam: each level hulls the
+// union of the vertices of both halves from scratch. Vertices are usually
+// a small part of the points, so that is cheap; on clouds where every
+// point is a vertex it costs as much as the hull of everything, once per
+// level. Point ids stay sorted, so answer() gives the same faces as
+// IncrementalHull::answer() on the whole set.
+template<typename Predicates = geometry::FastPredicates>
+class PrunedHull {
+public:
+    PrunedHull() = default;
+    explicit PrunedHull(const std::vector<Vector>& _points, size_t _threads = std::thread::hardware_concurrency())
+            : points(_points), threads(std::max<size_t>(1, _threads))
+    {}
+
+    void run() {
+        std::vector<size_t> ids(points.size());
+        std::iota(ids.begin(), ids.end(), 0);
+        if(threads == 1 || ids.size() < kMinSize) {
+            faces = m_faces(ids);
+        }
+        else {
+            faces = m_faces(m_split(ids.begin(), ids.end(), threads));
+        }
+    }
+
+    std::vector<std::array<size_t, 3>> answer() const {
+        return faces;
+    }
+private:
+    using Iterator = std::vector<size_t>::iterator;
+
+    static constexpr size_t kMinSize = 1 << 10;
+
+    std::vector<Vector> points;
+    size_t threads = 1;
+    std::vector<std::array<size_t, 3>> faces;
+
+    // Faces of the hull of points with the sorted ids.
+    std::vector<std::array<size_t, 3>> m_faces(const std::vector<size_t>& ids) const {
+        std::vector<Vector> part(ids.size());
+        for(size_t i = 0; i < ids.size(); ++i) {
+            part[i] = points[ids[i]];
+        }
+        IncrementalHull<Predicates> hull(part);
+        hull.run();
+        auto answer = hull.answer();
+        for(auto& face: answer) {
+            for(auto& v: face) {
+                v = ids[v];
+            }
+        }
+        return answer;
+    }
+
+    // Sorted ids of the hull vertices, all ids if the points are flat.
+    std::vector<size_t> m_vertices(const std::vector<size_t>& ids) const {
+        auto hull = m_faces(ids);
+        if(hull.empty()) {
+            return ids;
+        }
+        std::vector<size_t> vertices;
+        for(auto& face: hull) {
+            vertices.insert(vertices.end(), face.begin(), face.end());
+        }
+        std::sort(vertices.begin(), vertices.end());
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+        return vertices;
+    }
+
+    std::vector<size_t> m_vertices(Iterator begin, Iterator end, size_t threadsLeft) const {
+        if(threadsLeft == 1 || static_cast<size_t>(end - begin) < kMinSize) {
+            std::vector<size_t> ids(begin, end);
+            std::sort(ids.begin(), ids.end());
+            return m_vertices(ids);
+        }
+        return m_vertices(m_split(begin, end, threadsLeft));
+    }
+
+    // Sorted ids of the vertices of both halves by x.
+    std::vector<size_t> m_split(Iterator begin, Iterator end, size_t threadsLeft) const {
+        auto middle = begin + (end - begin) / 2;
+        std::nth_element(begin, middle, end, [this](size_t a, size_t b) {
+            return points[a].x < points[b].x;
+        });
+
+        std::vector<size_t> left;
+        std::thread worker([&]() {
+            left = m_vertices(begin, middle, threadsLeft / 2);
+        });
+        auto right = m_vertices(middle, end, threadsLeft - threadsLeft / 2);
+        worker.join();
+
+        std::vector<size_t> both(left.size() + right.size());
+        std::merge(left.begin(), left.end(), right.begin(), right.end(), both.begin());
+        return both;
+    }
+};
+
+// Hull of a changing point set by the logarithmic method: points live in
+// blocks, the i-th holding at most 2^i of them, and an insertion merges
+// full blocks like a binary counter carries, so every point goes through
+// O(log n) rebuilds of O(k log k). A block keeps its hull vertices, the
+// faces are the hull of the vertices of all blocks and are recomputed on
+// the first answer() after a change. So queries are not polylogarithmic:
+// that answer() costs O(h log h) for h block vertices in total, which can
+// be linear in the number of points; later ones return the cached faces.
+// Removing a point matters only if it is a vertex of its block hull; such
+// blocks are refreshed on answer(), so removals between two answers cost
+// one refresh per block. Once half of the points are removed all blocks
+// are rebuilt into one. Faces use the ids returned by insert() and are
+// ordered as in IncrementalHull::answer().
+template<typename Predicates = geometry::FastPredicates>
+class DynamicHull {
+public:
+    size_t insert(const Vector& point) {
+        size_t id = points.size();
+        points.push_back(point);
+        removed.push_back(false);
+        blockOf.push_back(0);
+
+        std::vector<size_t> carry(1, id);
+        size_t level = 0;
+        for(; level < blocks.size() && !blocks[level].ids.empty(); ++level) {
+            carry.insert(carry.end(), blocks[level].ids.begin(), blocks[level].ids.end());
+            blocks[level] = Block();
+        }
+        if(level == blocks.size()) {
+            blocks.emplace_back();
+        }
+        blocks[level].ids = std::move(carry);
+        m_rebuild(level);
+        return id;
+    }
+
+    void erase(size_t id) {
+        if(removed[id]) {
+            return;
+        }
+        removed[id] = true;
+        ++removedCount;
+        ++stale;
+        if(2 * stale > size() + stale) {
+            m_rebuildAll();
+            return;
+        }
+        auto& block = blocks[blockOf[id]];
+        if(std::binary_search(block.vertices.begin(), block.vertices.end(), id)) {
+            block.dirty = true;
+            changed = true;
+        }
+    }
+
+    size_t size() const {
+        return points.size() - removedCount;
+    }
+
+    const std::vector<std::array<size_t, 3>>& answer() {
+        if(changed) {
+            for(size_t level = 0; level < blocks.size(); ++level) {
+                if(blocks[level].dirty) {
+                    m_refresh(level);
+                }
+            }
+            std::vector<size_t> vertices;
+            for(auto& block: blocks) {
+                vertices.insert(vertices.end(), block.vertices.begin(), block.vertices.end());
+            }
+            std::sort(vertices.begin(), vertices.end());
+            faces.resize(m_hull(vertices, faces));
+            changed = false;
+        }
+        return faces;
+    }
+private:
+    // Blocks with more removed vertices exposing more faces are rebuilt.
+    static constexpr size_t kMaxExposed = 64;
+
+    struct Block {
+        std::vector<size_t> ids;
+        std::vector<size_t> vertices;
+        // Some vertices are removed.
+        bool dirty = false;
+    };
+
+    std::vector<Vector> points;
+    std::vector<bool> removed;
+    std::vector<size_t> blockOf;
+    size_t removedCount = 0;
+    // Removed points still listed in blocks.
+    size_t stale = 0;
+    std::vector<Block> blocks;
+
+    bool changed = false;
+    std::vector<std::array<size_t, 3>> faces;
+    IncrementalHull<Predicates> hull;
+    std::vector<Vector> part;
+    std::vector<std::array<size_t, 3>> buffer;
+
+    // Hull of the points with the sorted ids to output, returns the number of faces.
+    size_t m_hull(const std::vector<size_t>& ids, std::vector<std::array<size_t, 3>>& output) {
+        part.resize(ids.size());
+        for(size_t i = 0; i < ids.size(); ++i) {
+            part[i] = points[ids[i]];
+        }
+        hull.assign(part.begin(), part.end());
+        hull.run();
+        output.resize(std::max(output.size(), (ids.size() < 4) ? 0 : 2 * ids.size() - 4));
+        size_t size = hull.answer(output.data());
+        for(size_t i = 0; i < size; ++i) {
+            for(auto& v: output[i]) {
+                v = ids[v];
+            }
+        }
+        return size;
+    }
+
+    void m_rebuild(size_t level) {
+        auto& block = blocks[level];
+        size_t stored = block.ids.size();
+        block.ids.erase(std::remove_if(block.ids.begin(), block.ids.end(), [this](size_t id) {
+            return removed[id];
+        }), block.ids.end());
+        stale -= stored - block.ids.size();
+        std::sort(block.ids.begin(), block.ids.end());
+        for(auto id: block.ids) {
+            blockOf[id] = level;
+        }
+
+        size_t size = m_hull(block.ids, buffer);
+        if(size == 0) {
+            block.vertices = block.ids;
+            block.dirty = false;
+            changed = true;
+        }
+        else {
+            m_setVertices(block, size);
+        }
+    }
+
+    // Vertices of the first size faces in buffer.
+    void m_setVertices(Block& block, size_t size) {
+        block.vertices.clear();
+        for(size_t i = 0; i < size; ++i) {
+            block.vertices.insert(block.vertices.end(), buffer[i].begin(), buffer[i].end());
+        }
+        std::sort(block.vertices.begin(), block.vertices.end());
+        block.vertices.erase(std::unique(block.vertices.begin(), block.vertices.end()), block.vertices.end());
+        block.dirty = false;
+        changed = true;
+    }
+
+    // New vertices of a block with removed vertices: a point of the block
+    // outside the hull of the remaining vertices sees some of its faces,
+    // and each such face is seen by a removed vertex, so one scan of the
+    // block against those faces finds them. A block where most points are
+    // vertices, or the removed vertices see too many faces, is rebuilt.
+    void m_refresh(size_t level) {
+        auto& block = blocks[level];
+        std::vector<size_t> lost, kept;
+        for(auto id: block.vertices) {
+            (removed[id] ? lost : kept).push_back(id);
+        }
+        if(2 * block.vertices.size() > block.ids.size()) {
+            m_rebuild(level);
+            return;
+        }
+        size_t size = m_hull(kept, buffer);
+        if(size == 0) {
+            m_rebuild(level);
+            return;
+        }
+
+        std::vector<std::array<size_t, 3>> exposed;
+        for(size_t i = 0; i < size && exposed.size() <= kMaxExposed; ++i) {
+            auto& face = buffer[i];
+            for(auto id: lost) {
+                if(Predicates::orient3d(points[face[0]], points[face[1]], points[face[2]], points[id]) < 0) {
+                    exposed.push_back(face);
+                    break;
+                }
+            }
+        }
+        if(exposed.size() > kMaxExposed) {
+            m_rebuild(level);
+            return;
+        }
+
+        for(auto q: block.ids) {
+            if(removed[q]) {
+                continue;
+            }
+            for(auto& face: exposed) {
+                if(Predicates::orient3d(points[face[0]], points[face[1]], points[face[2]], points[q]) < 0) {
+                    kept.push_back(q);
+                    break;
+                }
+            }
+        }
+        std::sort(kept.begin(), kept.end());
+        m_setVertices(block, m_hull(kept, buffer));
+    }
+
+    void m_rebuildAll() {
+        std::vector<size_t> ids;
+        for(auto& block: blocks) {
+            ids.insert(ids.end(), block.ids.begin(), block.ids.end());
+        }
+        size_t level = 0;
+        while((size_t(1) << level) < ids.size()) {
+            ++level;
+        }
+        blocks.assign(level + 1, Block());
+        blocks[level].ids = std::move(ids);
+        m_rebuild(level);
+    }
+};
+
+
+// Many small hulls in one go: the point sets lie one after another in one
+// array, the i-th from offsets[i] to offsets[i + 1]; both arrays are kept in
+// the batch, empty offsets mean no sets. Each thread keeps one
+// IncrementalHull, so its buffers serve all its sets, and there is at most
+// one thread per kMinPart points. Faces go to one buffer laid out by the
+// 2n - 4 bound, so nothing is allocated per set after warm-up. Face ids
+// are local to their set.
+template<typename Predicates = geometry::FastPredicates>
+class HullBatch {
+public:
+    HullBatch(std::vector<Vector> _points, std::vector<size_t> _offsets)
+            : points(std::move(_points)), offsets(std::move(_offsets)) {
+        if(offsets.empty()) {
+            offsets.push_back(0);
+        }
+        faceBegin.assign(offsets.size(), 0);
+        faceCount.assign(offsets.size() - 1, 0);
+        for(size_t i = 0; i + 1 < offsets.size(); ++i) {
+            size_t n = offsets[i + 1] - offsets[i];
+            faceBegin[i + 1] = faceBegin[i] + ((n < 4) ? 0 : 2 * n - 4);
+        }
+        buffer.resize(faceBegin.back());
+    }
+
+    void run(size_t threads = std::thread::hardware_concurrency()) {
+        threads = std::max<size_t>(1, std::min({threads, size(), points.size() / kMinPart}));
+        auto work = [&](size_t t) {
+            IncrementalHull<Predicates> hull;
+            for(size_t i = t * size() / threads; i < (t + 1) * size() / threads; ++i) {
+                hull.assign(points.begin() + offsets[i], points.begin() + offsets[i + 1]);
+                hull.run();
+                faceCount[i] = hull.answer(buffer.data() + faceBegin[i]);
+            }
+        };
+        std::vector<std::thread> workers;
+        for(size_t t = 1; t < threads; ++t) {
+            workers.emplace_back(work, t);
+        }
+        work(0);
+        for(auto& worker: workers) {
+            worker.join();
+        }
+    }
+
+    size_t size() const {
+        return faceCount.size();
+    }
+
+    // Faces of the i-th set, in the order of IncrementalHull::answer().
+    const std::array<size_t, 3>* begin(size_t i) const {
+        return buffer.data() + faceBegin[i];
+    }
+    const std::array<size_t, 3>* end(size_t i) const {
+        return begin(i) + faceCount[i];
+    }
+private:
+    // Fewer points than that are not worth a thread.
+    static constexpr size_t kMinPart = 1 << 14;
+
+    std::vector<Vector> points;
+    std::vector<size_t> offsets;
+    std::vector<size_t> faceBegin;
+    std::vector<size_t> faceCount;
+    std::vector<std::array<size_t, 3>> buffer;
+};
+
 int main() {
     size_t m = 1, numPoints;
     std::vector<Vector> points;
+    std::vector<size_t> offsets(1, 0);
 
     std::cin >> m;
     for(size_t numTest = 0; numTest < m; ++numTest) {
         std::cin >> numPoints;
-        points.assign(numPoints, Vector(0, 0, 0));
-        for(auto& point: points) {
-            std::cin >> point.x >> point.y >> point.z;
+        points.resize(offsets.back() + numPoints);
+        for(size_t i = offsets.back(); i < points.size(); ++i) {
+            std::cin >> points[i].x >> points[i].y >> points[i].z;
         }
+        offsets.push_back(points.size());
+    }
 
-        GiftWrap algorithm(points);
-        algorithm.run();
-        auto answer = algorithm.answer();
-        std::printf("%ld\n", answer.size());
-        for(auto face: answer) {
-            std::cout << "3 " << face[0] << " " << face[1] << " " << face[2] << std::endl;
+    HullBatch<geometry::ExactPredicates> batch(std::move(points), std::move(offsets));
+    batch.run();
+    for(size_t i = 0; i < batch.size(); ++i) {
+        std::printf("%zu\n", static_cast<size_t>(batch.end(i) - batch.begin(i)));
+        for(auto face = batch.begin(i); face != batch.end(i); ++face) {
+            std::printf("3 %zu %zu %zu\n", (*face)[0], (*face)[1], (*face)[2]);
         }
-
-        points.clear();
     }
 }
@@ -1,95 +1,252 @@
 #include <iostream>
+#include <fstream>
 #include <array>
 #include <cmath>
 #include <iomanip>
 #include <algorithm>
 #include <limits>
 #include <vector>
-#include <functional>
+#include <thread>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
+#include "geometry.h"
 
-struct Vector{
-public:
-    Vector() : x(0), y(0)
-    {}
-    Vector(const Vector& v) = default;
-    Vector(Vector& v) = default;
-    Vector(Vector&& v) = default;
-    Vector& operator= (Vector v) {
-        x = v.x;
-        y = v.y;
-        return *this;
-    }
 
-    Vector(double _x, double _y): x(_x), y(_y)
-    {}
+using Vector = geometry::Vector<double, 2>;
 
-    double cross(Vector b) {
-        return x * b.y - y * b.x;
-    }
 
-    double x;
-    double y;
-};
+class Polygon{
+public:
+    Polygon() = default;
 
-Vector operator+(const Vector a, const Vector b) {
-    return Vector(a.x + b.x, a.y + b.y);
-}
+    void addPoint(const Vector& a) {
+        vectors.push_back(a);
+    }
 
-Vector operator-(const Vector a) {
-    return Vector(-a.x, -a.y);
-}
+    void clear() {
+        vectors.clear();
+    }
 
-Vector operator-(const Vector a, const Vector b) {
-    return Vector(a.x - b.x, a.y - b.y);
-}
+    friend Polygon operator-(const Polygon& a);
 
-Vector operator*(const Vector a, double b) {
-    return Vector(a.x * b, a.y * b);
-}
+    friend Polygon operator+(const Polygon& a, const Polygon& b);
 
-Vector operator/(const Vector a, double b) {
-    return Vector(a.x / b, a.y / b);
-}
+    // Minkowski sum of clockwise polygons. Both are walked from their
+    // lowest vertices by index, so nothing is copied; result keeps its
+    // buffer between calls and gets at most a.size() + b.size() vertices.
+    // Edges going the same way are merged, and so are collinear ones.
+    static void sum(const Polygon& a, const Polygon& b, Polygon& result) {
+        m_sum<false>(a, b, result);
+    }
 
+    // Minkowski sum of a and -b, b is not negated in memory.
+    static void difference(const Polygon& a, const Polygon& b, Polygon& result) {
+        m_sum<true>(a, b, result);
+    }
 
-class Polygon{
-public:
-    Polygon() = default;
+    size_t size() const {
+        return vectors.size();
+    }
 
-    void addPoint(const Vector& a) {
-        vectors.push_back(a);
+    // Whether clockwise polygons share a point, touching counts. No line
+    // through an edge of one polygon has the other strictly outside, the
+    // vertex of the other deepest inside the line is followed along as the
+    // edges turn, so the test is O(a.size() + b.size()), allocates nothing
+    // and stops at the first separating edge.
+    template<typename Predicates = geometry::FastPredicates>
+    static bool intersect(const Polygon& a, const Polygon& b) {
+        return !m_separates<Predicates>(a, b) && !m_separates<Predicates>(b, a);
     }
 
-    friend Polygon operator-(Polygon a);
+    // Intersection of clockwise polygons into result by O'Rourke's edge
+    // chasing: the edge that points at the other one advances, crossings
+    // and vertices inside the other polygon go to the output on the way,
+    // and both boundaries are passed at most twice, O(a.size() + b.size()).
+    // Polygons with less than three vertices give an empty result.
+    template<typename Predicates = geometry::FastPredicates>
+    static void intersection(const Polygon& a, const Polygon& b, Polygon& result) {
+        result.vectors.clear();
+        size_t n = a.vectors.size(), m = b.vectors.size();
+        if(n < 3 || m < 3) {
+            return;
+        }
+        result.vectors.reserve(n + m);
 
-    friend Polygon operator+(Polygon a, Polygon b);
+        // The algorithm goes counterclockwise, so both are read backwards.
+        auto vertexA = [&](size_t i) -> const Vector& {
+            return a.vectors[n - 1 - i];
+        };
+        auto vertexB = [&](size_t j) -> const Vector& {
+            return b.vectors[m - 1 - j];
+        };
+        enum class Inside {
+            kUnknown, kA, kB
+        };
+        Inside inside = Inside::kUnknown;
+        size_t i = 0, j = 0, advancesA = 0, advancesB = 0;
+        bool first = true;
+        do {
+            const Vector& a0 = vertexA((i == 0) ? n - 1 : i - 1);
+            const Vector& a1 = vertexA(i);
+            const Vector& b0 = vertexB((j == 0) ? m - 1 : j - 1);
+            const Vector& b1 = vertexB(j);
+            double turn = (a1 - a0).cross(b1 - b0);
+            int aOnB = Predicates::orient2d(b0, b1, a1), bOnA = Predicates::orient2d(a0, a1, b1);
 
-    bool contain(Vector point) {
-        std::function<int(Vector a, Vector b, Vector c)> leftTurn = []
-                (Vector a, Vector b, Vector c){
-            if((b - a).cross(c - a) > 0) {
-                return 1;
+            Vector p, q;
+            char meet = m_meet<Predicates>(a0, a1, b0, b1, p, q);
+            if(meet == '1' || meet == 'v') {
+                if(inside == Inside::kUnknown && first) {
+                    advancesA = advancesB = 0;
+                    first = false;
+                }
+                result.m_append(p);
+                if(aOnB > 0) {
+                    inside = Inside::kA;
+                }
+                else if(bOnA > 0) {
+                    inside = Inside::kB;
+                }
+            }
+            if(meet == 'e' && (a1 - a0).dot(b1 - b0) < 0) {
+                result.vectors.assign({q, p});
+                result.m_close();
+                return;
+            }
+
+            bool advanceA;
+            if(turn == 0 && aOnB < 0 && bOnA < 0) {
+                result.vectors.clear();
+                return;
             }
-            else if ((b - a).cross(c - a) < 0) {
-                return  -1;
+            else if(turn == 0 && aOnB == 0 && bOnA == 0) {
+                advanceA = (inside != Inside::kA);
+            }
+            else if(turn >= 0) {
+                advanceA = (bOnA > 0);
             }
             else {
-                return 0;
+                advanceA = !(aOnB > 0);
             }
-        };
+            if(advanceA) {
+                if(inside == Inside::kA) {
+                    result.m_append(a1);
+                }
+                ++advancesA;
+                i = (i + 1 == n) ? 0 : i + 1;
+            }
+            else {
+                if(inside == Inside::kB) {
+                    result.m_append(b1);
+                }
+                ++advancesB;
+                j = (j + 1 == m) ? 0 : j + 1;
+            }
+        } while((advancesA < n || advancesB < m) && advancesA < 2 * n && advancesB < 2 * m);
 
-        for(size_t i = 0; i < vectors.size(); ++i) {
-            if(leftTurn(vectors[(i + 1) % vectors.size()], vectors[i], point) < 0) {
-                return false;
+        if(inside == Inside::kUnknown) {
+            // The boundaries do not cross, one may hold the other.
+            if(m_inside<Predicates>(a, b)) {
+                result.vectors = a.vectors;
+            }
+            else if(m_inside<Predicates>(b, a)) {
+                result.vectors = b.vectors;
             }
+            else {
+                result.vectors.clear();
+            }
+            return;
         }
+        result.m_close();
+        std::reverse(result.vectors.begin(), result.vectors.end());
+    }
 
-        return true;
+    friend class PointLocator;
+
+    friend class PolygonFile;
+
+    // Inside or on the border, vertices go clockwise. Binary search over the
+    // fan of triangles from the first vertex, O(log n). A point on the line
+    // of the first or the last edge is inside only on the border there,
+    // which runs up to the farthest vertex collinear with that edge.
+    template<typename Predicates = geometry::FastPredicates>
+    bool contain(const Vector& point) const {
+        size_t n = vectors.size();
+        if(n < 3) {
+            for(size_t i = 0; i < n; ++i) {
+                if(Predicates::orient2d(vectors[(i + 1) % n], vectors[i], point) < 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        const Vector& origin = vectors[0];
+        int first = Predicates::orient2d(origin, vectors[1], point);
+        int last = Predicates::orient2d(origin, vectors[n - 1], point);
+        if(first > 0 || last < 0) {
+            return false;
+        }
+        if(first == 0 || last == 0) {
+            return (first == 0 && m_between(origin, vectors[m_rayEnd<Predicates, true>()], point)) ||
+                   (last == 0 && m_between(origin, vectors[m_rayEnd<Predicates, false>()], point));
+        }
+        size_t low = 1, high = n - 1;
+        while(high - low > 1) {
+            size_t middle = (low + high) / 2;
+            if(Predicates::orient2d(origin, vectors[middle], point) <= 0) {
+                low = middle;
+            }
+            else {
+                high = middle;
+            }
+        }
+        return Predicates::orient2d(vectors[low + 1], vectors[low], point) >= 0;
     }
 private:
     std::vector<Vector> vectors;
 
+    // Whether point, known to be on the line through a and b, lies between them.
+    static bool m_between(const Vector& a, const Vector& b, const Vector& point) {
+        return std::min(a.x, b.x) <= point.x && point.x <= std::max(a.x, b.x) &&
+               std::min(a.y, b.y) <= point.y && point.y <= std::max(a.y, b.y);
+    }
+
+    // Index of the farthest vertex on the ray from the first vertex through
+    // the second one, or through the last one unless Forward is set. The
+    // vertices on the ray come in a row, so a binary search finds the end.
+    template<typename Predicates, bool Forward>
+    size_t m_rayEnd() const {
+        size_t n = vectors.size();
+        const Vector& origin = vectors[0];
+        const Vector& direction = vectors[Forward ? 1 : n - 1];
+        auto onRay = [&](size_t i) {
+            return Predicates::orient2d(origin, direction, vectors[i]) == 0 &&
+                   (vectors[i] - origin).dot(direction - origin) > 0;
+        };
+        // The answer is in [low, high], counted from the start of the row.
+        size_t low = 1, high = n - 1;
+        while(low < high) {
+            size_t middle = (low + high + 1) / 2;
+            if(onRay(Forward ? middle : n - middle)) {
+                low = middle;
+            }
+            else {
+                high = middle - 1;
+            }
+        }
+        return Forward ? low : n - low;
+    }
+
     void m_leftDownToFirst() {
         auto min = vectors.begin();
         for(auto i = vectors.begin(); i != vectors.end(); ++i) {
@@ -104,48 +261,835 @@ private:
         }
         std::rotate(vectors.begin(), min, vectors.end());
     }
+
+    // Index of the vertex m_leftDownToFirst would put first, or of the
+    // first of -polygon when Negate is set.
+    template<bool Negate>
+    size_t m_lowest() const {
+        size_t min = 0;
+        for(size_t i = 1; i < vectors.size(); ++i) {
+            const Vector& v = vectors[i];
+            const Vector& m = vectors[min];
+            bool lower = Negate ? (v.y > m.y || (v.y == m.y && v.x > m.x)) : (v.y < m.y || (v.y == m.y && v.x < m.x));
+            if(lower) {
+                min = i;
+            }
+        }
+        return min;
+    }
+
+    // Vertex i, counting from start, of the polygon or of -polygon.
+    template<bool Negate>
+    Vector m_vertex(size_t start, size_t i) const {
+        i += start;
+        if(i >= vectors.size()) {
+            i -= vectors.size();
+        }
+        return Negate ? -vectors[i] : vectors[i];
+    }
+
+    // Appends a vertex, replacing the last one if it lies on the segment.
+    void m_append(const Vector& v) {
+        size_t n = vectors.size();
+        if(n >= 1 && vectors[n - 1] == v) {
+            return;
+        }
+        if(n >= 2 && (vectors[n - 1] - vectors[n - 2]).cross(v - vectors[n - 1]) == 0) {
+            vectors[n - 1] = v;
+        }
+        else {
+            vectors.push_back(v);
+        }
+    }
+
+    // Drops the last vertices while they repeat the first one or lie on
+    // the closing edge, and the first one if it lies on an edge.
+    void m_close() {
+        while(vectors.size() >= 2 && (vectors.back() == vectors[0] || (vectors.size() >= 3 &&
+              (vectors[vectors.size() - 1] - vectors[vectors.size() - 2]).cross(vectors[0] - vectors.back()) == 0))) {
+            vectors.pop_back();
+        }
+        if(vectors.size() >= 3 && (vectors[0] - vectors.back()).cross(vectors[1] - vectors[0]) == 0) {
+            vectors.erase(vectors.begin());
+        }
+    }
+
+    // All vertices of a are in b.
+    template<typename Predicates>
+    static bool m_inside(const Polygon& a, const Polygon& b) {
+        for(auto& v: a.vectors) {
+            if(!b.contain<Predicates>(v)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // How segments ab and cd meet: '0' they do not, '1' they cross at p
+    // inside both, 'v' p is an endpoint of one on the other, 'e' they
+    // overlap along a line from p to q.
+    template<typename Predicates>
+    static char m_meet(const Vector& a, const Vector& b, const Vector& c, const Vector& d, Vector& p, Vector& q) {
+        int abc = Predicates::orient2d(a, b, c), abd = Predicates::orient2d(a, b, d);
+        if(abc == 0 && abd == 0) {
+            return m_overlap(a, b, c, d, p, q);
+        }
+        int cda = Predicates::orient2d(c, d, a), cdb = Predicates::orient2d(c, d, b);
+        if(abc * abd > 0 || cda * cdb > 0) {
+            return '0';
+        }
+        if(abc == 0 || abd == 0 || cda == 0 || cdb == 0) {
+            p = (abc == 0) ? c : ((abd == 0) ? d : ((cda == 0) ? a : b));
+            return 'v';
+        }
+        p = a + (b - a) * ((c - a).cross(d - c) / (b - a).cross(d - c));
+        return '1';
+    }
+
+    // Common part of collinear segments ab and cd.
+    static char m_overlap(const Vector& a, const Vector& b, const Vector& c, const Vector& d, Vector& p, Vector& q) {
+        auto between = [](const Vector& from, const Vector& to, const Vector& v) {
+            if(from.x != to.x) {
+                return std::min(from.x, to.x) <= v.x && v.x <= std::max(from.x, to.x);
+            }
+            return std::min(from.y, to.y) <= v.y && v.y <= std::max(from.y, to.y);
+        };
+        bool cOnAB = between(a, b, c), dOnAB = between(a, b, d);
+        bool aOnCD = between(c, d, a), bOnCD = between(c, d, b);
+        if(cOnAB && dOnAB) {
+            p = c;
+            q = d;
+        }
+        else if(aOnCD && bOnCD) {
+            p = a;
+            q = b;
+        }
+        else if(cOnAB && (aOnCD || bOnCD)) {
+            p = c;
+            q = bOnCD ? b : a;
+        }
+        else if(dOnAB && (aOnCD || bOnCD)) {
+            p = d;
+            q = bOnCD ? b : a;
+        }
+        else {
+            return '0';
+        }
+        return 'e';
+    }
+
+    // Some edge of a has b strictly outside.
+    template<typename Predicates>
+    static bool m_separates(const Polygon& a, const Polygon& b) {
+        size_t n = a.vectors.size(), m = b.vectors.size();
+        if(n == 0 || m == 0) {
+            return true;
+        }
+
+        size_t deepest = 0;
+        bool found = false;
+        for(size_t i = 0; i < n; ++i) {
+            const Vector& from = a.vectors[i];
+            const Vector& to = a.vectors[(i + 1 == n) ? 0 : i + 1];
+            if(from == to) {
+                continue;
+            }
+            Vector edge = from - to;
+            // The climb below only goes forward, so it needs a start on the
+            // rising side: the first real edge scans for it.
+            if(!found) {
+                found = true;
+                for(size_t j = 1; j < m; ++j) {
+                    if(edge.cross(b.vectors[j]) > edge.cross(b.vectors[deepest])) {
+                        deepest = j;
+                    }
+                }
+            }
+            // A repeated vertex is a flat spot on the way up, it is passed.
+            for(size_t step = 0; step < m; ++step) {
+                size_t next = (deepest + 1 == m) ? 0 : deepest + 1;
+                double here = edge.cross(b.vectors[deepest]), there = edge.cross(b.vectors[next]);
+                if(there < here || (there == here && b.vectors[next] != b.vectors[deepest])) {
+                    break;
+                }
+                deepest = next;
+            }
+            if(Predicates::orient2d(to, from, b.vectors[deepest]) < 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<bool Negate>
+    static void m_sum(const Polygon& a, const Polygon& b, Polygon& result) {
+        size_t aSize = a.vectors.size(), bSize = b.vectors.size();
+        size_t aStart = a.m_lowest<false>(), bStart = b.m_lowest<Negate>();
+        result.vectors.clear();
+        result.vectors.reserve(aSize + bSize);
+
+        size_t it_1 = 0, it_2 = 0;
+        while((it_1 < aSize) && (it_2 < bSize)) {
+            Vector a1 = a.m_vertex<false>(aStart, it_1), b1 = b.m_vertex<Negate>(bStart, it_2);
+            auto v1 = a.m_vertex<false>(aStart, it_1 + 1) - a1;
+            auto v2 = b.m_vertex<Negate>(bStart, it_2 + 1) - b1;
+            result.m_append(a1 + b1);
+            double cross = v1.cross(v2);
+            if(cross < -1e-10) {
+                ++it_1;
+            }
+            else if(cross > 1e-10) {
+                ++it_2;
+            }
+            else {
+                ++it_1;
+                ++it_2;
+            }
+        }
+
+        for(; it_1 < aSize; ++it_1) {
+            result.m_append(a.m_vertex<false>(aStart, it_1) + b.m_vertex<Negate>(bStart, 0));
+        }
+
+        for(; it_2 < bSize; ++it_2) {
+            result.m_append(a.m_vertex<false>(aStart, 0) + b.m_vertex<Negate>(bStart, it_2));
+        }
+
+        result.m_close();
+    }
 };
 
-Polygon operator-(Polygon a) {
+Polygon operator-(const Polygon& a) {
     Polygon res;
+    res.vectors.reserve(a.vectors.size());
     for(auto& v: a.vectors) {
         res.addPoint(-v);
     }
     return res;
 }
 
-Polygon operator+(Polygon a, Polygon b) {
+Polygon operator+(const Polygon& a, const Polygon& b) {
     Polygon res;
-    size_t it_1 = 0, it_2 = 0;
-    a.m_leftDownToFirst();
-    b.m_leftDownToFirst();
+    Polygon::sum(a, b, res);
+    return res;
+}
+
 
-    while((it_1 < a.vectors.size()) && (it_2 < b.vectors.size())) {
-        auto v1 = a.vectors[(it_1 + 1) % a.vectors.size()] - a.vectors[it_1];
-        auto v2 = b.vectors[(it_2 + 1) % b.vectors.size()] - b.vectors[it_2];
-        res.addPoint(a.vectors[it_1] + b.vectors[it_2]);
-        if(v1.cross(v2) < -1e-10) {
-            ++it_1;
+// Many containment queries against one polygon: the fan around the lowest
+// vertex is kept as coordinates relative to it, and the batch query runs
+// the binary searches of 4 * kGroups points at once with AVX2 gathers.
+// Collinear vertices are dropped, so a point on the line of the first or
+// the last fan edge is inside exactly when it is on that edge. Answers are
+// the same as Polygon::contain with plain arithmetic.
+class PointLocator {
+public:
+    explicit PointLocator(const Polygon& _polygon): polygon(_polygon) {
+        Polygon fan;
+        for(auto& v: polygon.vectors) {
+            fan.m_append(v);
         }
-        else if (v1.cross(v2) > 1e-10){
-            ++it_2;
+        fan.m_close();
+        if(fan.vectors.size() < 3) {
+            return;
         }
-        else {
-            ++it_1;
-            ++it_2;
+        fan.m_leftDownToFirst();
+        origin = fan.vectors[0];
+        for(size_t i = 1; i < fan.vectors.size(); ++i) {
+            fanX.push_back(fan.vectors[i].x - origin.x);
+            fanY.push_back(fan.vectors[i].y - origin.y);
+        }
+    }
+
+    bool contain(const Vector& point) const {
+        if(fanX.empty()) {
+            return polygon.contain(point);
+        }
+        double dx = point.x - origin.x, dy = point.y - origin.y;
+        size_t last = fanX.size() - 1;
+        double firstCross = m_cross(0, dx, dy), lastCross = m_cross(last, dx, dy);
+        if(firstCross > 0 || lastCross < 0) {
+            return false;
+        }
+        if(firstCross == 0 || lastCross == 0) {
+            return (firstCross == 0 && m_onEdge(0, dx, dy)) || (lastCross == 0 && m_onEdge(last, dx, dy));
         }
+        size_t base = 0;
+        for(size_t size = last; size > 1; size -= size / 2) {
+            if(m_cross(base + size / 2, dx, dy) <= 0) {
+                base += size / 2;
+            }
+        }
+        double edgeX = fanX[base] - fanX[base + 1], edgeY = fanY[base] - fanY[base + 1];
+        return edgeX * (dy - fanY[base + 1]) - edgeY * (dx - fanX[base + 1]) >= 0;
     }
 
-    for(; it_1 < a.vectors.size(); ++it_1) {
-        res.addPoint(a.vectors[it_1] + b.vectors[0]);
+    // result[i] tells whether (x[i], y[i]) is inside or on the border.
+    void contain(const double* x, const double* y, size_t size, bool* result) const {
+        size_t i = 0;
+#ifdef __AVX2__
+        if(!fanX.empty()) {
+            for(; i + 4 * kGroups <= size; i += 4 * kGroups) {
+                int mask = m_contain(x + i, y + i);
+                for(size_t j = 0; j < 4 * kGroups; ++j) {
+                    result[i + j] = (mask >> j) & 1;
+                }
+            }
+        }
+#endif
+        for(; i < size; ++i) {
+            result[i] = contain(Vector(x[i], y[i]));
+        }
     }
+private:
+    Polygon polygon;
+    Vector origin;
+    std::vector<double> fanX;
+    std::vector<double> fanY;
 
-    for(; it_2 < b.vectors.size(); ++it_2) {
-        res.addPoint(a.vectors[0] + b.vectors[it_2]);
+    // Pseudo-scalar product of the i-th fan vertex and the point, both relative to the origin.
+    double m_cross(size_t i, double dx, double dy) const {
+        return fanX[i] * dy - fanY[i] * dx;
     }
 
-    return res;
-}
+    // Whether the point, known to be on the line of the i-th fan vertex, is
+    // between it and the origin.
+    bool m_onEdge(size_t i, double dx, double dy) const {
+        return std::min(0.0, fanX[i]) <= dx && dx <= std::max(0.0, fanX[i]) &&
+               std::min(0.0, fanY[i]) <= dy && dy <= std::max(0.0, fanY[i]);
+    }
+
+#ifdef __AVX2__
+    // Bit j of the mask is set if point j of the 4 * kGroups is inside; the
+    // independent groups hide the latency of the gathers.
+    static constexpr size_t kGroups = 4;
+
+    int m_contain(const double* x, const double* y) const {
+        __m256d dx[kGroups], dy[kGroups], inside[kGroups], onLine[kGroups], onEdge[kGroups];
+        __m256i base[kGroups];
+        long long last = fanX.size() - 1;
+        __m256d zero = _mm256_setzero_pd();
+        for(size_t g = 0; g < kGroups; ++g) {
+            dx[g] = _mm256_sub_pd(_mm256_loadu_pd(x + 4 * g), _mm256_set1_pd(origin.x));
+            dy[g] = _mm256_sub_pd(_mm256_loadu_pd(y + 4 * g), _mm256_set1_pd(origin.y));
+            __m256d firstCross = m_cross(_mm256_setzero_si256(), dx[g], dy[g]);
+            __m256d lastCross = m_cross(_mm256_set1_epi64x(last), dx[g], dy[g]);
+            inside[g] = _mm256_and_pd(_mm256_cmp_pd(firstCross, zero, _CMP_LE_OQ),
+                                      _mm256_cmp_pd(lastCross, zero, _CMP_GE_OQ));
+            __m256d onFirst = _mm256_cmp_pd(firstCross, zero, _CMP_EQ_OQ);
+            __m256d onLast = _mm256_cmp_pd(lastCross, zero, _CMP_EQ_OQ);
+            onLine[g] = _mm256_or_pd(onFirst, onLast);
+            onEdge[g] = _mm256_or_pd(_mm256_and_pd(onFirst, m_onEdge(0, dx[g], dy[g])),
+                                     _mm256_and_pd(onLast, m_onEdge(last, dx[g], dy[g])));
+            base[g] = _mm256_setzero_si256();
+        }
+
+        for(long long size = last; size > 1; size -= size / 2) {
+            for(size_t g = 0; g < kGroups; ++g) {
+                __m256i middle = _mm256_add_epi64(base[g], _mm256_set1_epi64x(size / 2));
+                __m256d less = _mm256_cmp_pd(m_cross(middle, dx[g], dy[g]), _mm256_setzero_pd(), _CMP_LE_OQ);
+                base[g] = _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(base[g]),
+                                                               _mm256_castsi256_pd(middle), less));
+            }
+        }
+
+        int mask = 0;
+        for(size_t g = 0; g < kGroups; ++g) {
+            __m256i next = _mm256_add_epi64(base[g], _mm256_set1_epi64x(1));
+            __m256d ax = _mm256_i64gather_pd(fanX.data(), base[g], 8);
+            __m256d ay = _mm256_i64gather_pd(fanY.data(), base[g], 8);
+            __m256d bx = _mm256_i64gather_pd(fanX.data(), next, 8);
+            __m256d by = _mm256_i64gather_pd(fanY.data(), next, 8);
+            __m256d edge = _mm256_sub_pd(_mm256_mul_pd(_mm256_sub_pd(ax, bx), _mm256_sub_pd(dy[g], by)),
+                                         _mm256_mul_pd(_mm256_sub_pd(ay, by), _mm256_sub_pd(dx[g], bx)));
+            __m256d right = _mm256_blendv_pd(_mm256_cmp_pd(edge, zero, _CMP_GE_OQ), onEdge[g], onLine[g]);
+            inside[g] = _mm256_and_pd(inside[g], right);
+            mask |= _mm256_movemask_pd(inside[g]) << (4 * g);
+        }
+        return mask;
+    }
+
+    __m256d m_cross(__m256i index, __m256d dx, __m256d dy) const {
+        __m256d vx = _mm256_i64gather_pd(fanX.data(), index, 8);
+        __m256d vy = _mm256_i64gather_pd(fanY.data(), index, 8);
+        return _mm256_sub_pd(_mm256_mul_pd(vx, dy), _mm256_mul_pd(vy, dx));
+    }
+
+    __m256d m_onEdge(size_t i, __m256d dx, __m256d dy) const {
+        __m256d lowX = _mm256_set1_pd(std::min(0.0, fanX[i])), highX = _mm256_set1_pd(std::max(0.0, fanX[i]));
+        __m256d lowY = _mm256_set1_pd(std::min(0.0, fanY[i])), highY = _mm256_set1_pd(std::max(0.0, fanY[i]));
+        return _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(lowX, dx, _CMP_LE_OQ), _mm256_cmp_pd(dx, highX, _CMP_LE_OQ)),
+                             _mm256_and_pd(_mm256_cmp_pd(lowY, dy, _CMP_LE_OQ), _mm256_cmp_pd(dy, highY, _CMP_LE_OQ)));
+    }
+#endif
+};
+
+// Intersection tests for many pairs of polygons, pairs[i] holds indices
+// into polygons. Both vectors are referenced, not copied, and must outlive
+// the batch. The pairs are split evenly between the threads, one thread per
+// kMinPart pairs at most, so small batches run on the calling thread.
+template<typename Predicates = geometry::FastPredicates>
+class IntersectionBatch {
+public:
+    IntersectionBatch(const std::vector<Polygon>& _polygons, const std::vector<std::pair<size_t, size_t>>& _pairs):
+            polygons(_polygons), pairs(_pairs), result(_pairs.size(), false) {
+    }
+
+    void run(size_t threads = std::thread::hardware_concurrency()) {
+        threads = std::max<size_t>(1, std::min(threads, pairs.size() / kMinPart));
+        std::vector<std::thread> workers;
+        for(size_t t = 1; t < threads; ++t) {
+            workers.emplace_back(&IntersectionBatch::m_run, this, pairs.size() * t / threads,
+                                 pairs.size() * (t + 1) / threads);
+        }
+        m_run(0, pairs.size() / threads);
+        for(auto& worker: workers) {
+            worker.join();
+        }
+    }
+
+    size_t size() const {
+        return pairs.size();
+    }
+
+    bool intersect(size_t i) const {
+        return result[i];
+    }
+private:
+    // Fewer pairs than that are not worth a thread.
+    static constexpr size_t kMinPart = 1 << 10;
+
+    const std::vector<Polygon>& polygons;
+    const std::vector<std::pair<size_t, size_t>>& pairs;
+    // Not vector<bool>, threads write neighbouring elements.
+    std::vector<char> result;
+
+    void m_run(size_t begin, size_t end) {
+        for(size_t i = begin; i < end; ++i) {
+            result[i] = Polygon::intersect<Predicates>(polygons[pairs[i].first], polygons[pairs[i].second]);
+        }
+    }
+};
+
+
+// Polygons stored one after another in a binary file: the number of
+// vertices as uint64_t, then x and y of every vertex as doubles. The file
+// is mapped to memory and read sequentially into one reused Polygon, so
+// files larger than memory stream through the page cache.
+class PolygonFile {
+public:
+    PolygonFile() = default;
+    PolygonFile(const PolygonFile&) = delete;
+    PolygonFile& operator=(const PolygonFile&) = delete;
+
+    ~PolygonFile() {
+        m_unmap();
+    }
+
+    bool open(const char* path) {
+        m_unmap();
+        int descriptor = ::open(path, O_RDONLY);
+        if(descriptor < 0) {
+            return false;
+        }
+        struct stat status;
+        if(fstat(descriptor, &status) == 0 && status.st_size > 0) {
+            void* mapped = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if(mapped != MAP_FAILED) {
+                data = static_cast<const char*>(mapped);
+                length = status.st_size;
+                madvise(mapped, length, MADV_SEQUENTIAL);
+            }
+        }
+        close(descriptor);
+        return data != nullptr;
+    }
+
+    static bool write(const char* path, const std::vector<Polygon>& polygons) {
+        std::ofstream out(path, std::ios::binary);
+        for(auto& polygon: polygons) {
+            uint64_t size = polygon.vectors.size();
+            out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            for(auto& v: polygon.vectors) {
+                out.write(reinterpret_cast<const char*>(&v.x), sizeof(double));
+                out.write(reinterpret_cast<const char*>(&v.y), sizeof(double));
+            }
+        }
+        return bool(out);
+    }
+
+    // Calls callback(index, polygon) for every whole polygon in the file and
+    // returns their number; the polygon is only valid during the call.
+    template<typename Callback>
+    size_t forEach(Callback callback) const {
+        Polygon polygon;
+        size_t count = 0, offset = 0;
+        while(offset + sizeof(uint64_t) <= length) {
+            uint64_t size;
+            std::memcpy(&size, data + offset, sizeof(size));
+            offset += sizeof(size);
+            if(size > (length - offset) / (2 * sizeof(double))) {
+                break;
+            }
+            polygon.vectors.resize(size);
+            for(auto& v: polygon.vectors) {
+                std::memcpy(&v.x, data + offset, sizeof(double));
+                std::memcpy(&v.y, data + offset + sizeof(double), sizeof(double));
+                offset += 2 * sizeof(double);
+            }
+            callback(count++, static_cast<const Polygon&>(polygon));
+        }
+        return count;
+    }
+
+    // Calls callback(index, intersection) with the intersection of clip
+    // and every polygon in the file. Polygons outside the bounding box of
+    // clip get an empty intersection without the edge chasing.
+    template<typename Predicates = geometry::FastPredicates, typename Callback>
+    size_t clip(const Polygon& clip, Callback callback) const {
+        Vector low, high;
+        m_box(clip, low, high);
+        Polygon result;
+        return forEach([&](size_t i, const Polygon& polygon) {
+            Vector polygonLow, polygonHigh;
+            m_box(polygon, polygonLow, polygonHigh);
+            if(polygonHigh.x < low.x || high.x < polygonLow.x || polygonHigh.y < low.y || high.y < polygonLow.y) {
+                result.clear();
+            }
+            else {
+                Polygon::intersection<Predicates>(clip, polygon, result);
+            }
+            callback(i, static_cast<const Polygon&>(result));
+        });
+    }
+private:
+    const char* data = nullptr;
+    size_t length = 0;
+
+    static void m_box(const Polygon& polygon, Vector& low, Vector& high) {
+        low = Vector(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+        high = -low;
+        for(auto& v: polygon.vectors) {
+            low = Vector(std::min(low.x, v.x), std::min(low.y, v.y));
+            high = Vector(std::max(high.x, v.x), std::max(high.y, v.y));
+        }
+    }
+
+    void m_unmap() {
+        if(data != nullptr) {
+            munmap(const_cast<char*>(data), length);
+            data = nullptr;
+            length = 0;
+        }
+    }
+};
+
+
+// Convex hulls of unordered points as clockwise polygons without
+// collinear vertices, starting from the leftmost lowest point. Sorting,
+// filtering and the hulls of groups run on up to the given number of
+// threads, one per kMinPart points.
+template<typename Predicates = geometry::FastPredicates>
+class HullBuilder {
+public:
+    explicit HullBuilder(size_t _threads = std::thread::hardware_concurrency()):
+            threads(std::max<size_t>(1, _threads)) {
+    }
+
+    // Andrew's monotone chain, O(n log n); points get sorted in place.
+    Polygon monotoneChain(std::vector<Vector>& points) const {
+        if(points.empty()) {
+            return Polygon();
+        }
+        m_sort(points);
+        std::vector<Vector> hull;
+        m_chain(points.data(), points.size(), hull);
+        return m_polygon(hull);
+    }
+
+    // Chan's algorithm, O(n log h) for h vertices: hulls of groups of m
+    // points are wrapped by Jarvis's march with a binary search for the
+    // tangent to every group, and m is squared until the march closes in
+    // m steps. Points strictly inside the octagon of the extreme points in
+    // eight directions are dropped first.
+    Polygon chan(const std::vector<Vector>& input) const {
+        if(input.empty()) {
+            return Polygon();
+        }
+        std::vector<Vector> points = m_filter(input);
+        size_t n = points.size(), start = 0;
+        for(size_t i = 1; i < n; ++i) {
+            if(m_less(points[i], points[start])) {
+                start = i;
+            }
+        }
+
+        std::vector<Vector> hulls, march;
+        std::vector<size_t> offsets;
+        for(size_t round = 1;; ++round) {
+            size_t m = (round >= 6) ? n : std::min(n, size_t(1) << (size_t(1) << round));
+            m_groupHulls(points, m, hulls, offsets);
+            if(m_march(points[start], hulls, offsets, m, march)) {
+                return m_polygon(march);
+            }
+        }
+    }
+private:
+    // Parts smaller than that are not worth a thread.
+    static constexpr size_t kMinPart = 1 << 16;
+    // Tangents to hulls this small are found by a scan.
+    static constexpr size_t kMinSearch = 8;
+
+    size_t threads;
+
+    static bool m_less(const Vector& a, const Vector& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    }
+
+    static Polygon m_polygon(const std::vector<Vector>& vertices) {
+        Polygon result;
+        for(auto& v: vertices) {
+            result.addPoint(v);
+        }
+        return result;
+    }
+
+    // Threads for work over n points, one per kMinPart of them; small
+    // inputs stay on the calling thread.
+    size_t m_workers(size_t n) const {
+        return std::max<size_t>(1, std::min(threads, n / kMinPart));
+    }
+
+    // Calls work(i) for i below count, spread over the threads.
+    template<typename Work>
+    void m_parallel(size_t count, size_t workers, Work work) const {
+        workers = std::max<size_t>(1, std::min(workers, count));
+        auto run = [&](size_t t) {
+            for(size_t i = count * t / workers; i < count * (t + 1) / workers; ++i) {
+                work(i);
+            }
+        };
+        std::vector<std::thread> pool;
+        for(size_t t = 1; t < workers; ++t) {
+            pool.emplace_back(run, t);
+        }
+        run(0);
+        for(auto& thread: pool) {
+            thread.join();
+        }
+    }
+
+    // Sorted parts merged pairwise, a round of merges at a time.
+    void m_sort(std::vector<Vector>& points) const {
+        size_t parts = m_workers(points.size());
+        std::vector<size_t> bounds(parts + 1);
+        for(size_t i = 0; i <= parts; ++i) {
+            bounds[i] = points.size() * i / parts;
+        }
+        auto begin = points.begin();
+        m_parallel(parts, parts, [&](size_t i) {
+            std::sort(begin + bounds[i], begin + bounds[i + 1], m_less);
+        });
+        for(size_t width = 1; width < parts; width *= 2) {
+            size_t merges = (parts + 2 * width - 1) / (2 * width);
+            m_parallel(merges, merges, [&](size_t i) {
+                size_t first = 2 * width * i, middle = std::min(first + width, parts);
+                size_t last = std::min(first + 2 * width, parts);
+                std::inplace_merge(begin + bounds[first], begin + bounds[middle], begin + bounds[last], m_less);
+            });
+        }
+    }
+
+    // Points not strictly inside the octagon of extreme points, the
+    // directions are the axes and the diagonals.
+    std::vector<Vector> m_filter(const std::vector<Vector>& points) const {
+        static constexpr int kDirections[8][2] = {{-1, 0}, {-1, 1}, {0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}};
+        auto height = [](const Vector& v, size_t d) {
+            return kDirections[d][0] * v.x + kDirections[d][1] * v.y;
+        };
+        std::array<Vector, 8> octagon;
+        octagon.fill(points[0]);
+        for(auto& v: points) {
+            for(size_t d = 0; d < 8; ++d) {
+                if(height(v, d) > height(octagon[d], d)) {
+                    octagon[d] = v;
+                }
+            }
+        }
+
+        // Clockwise from the leftmost, inside means a right turn from every edge.
+        size_t workers = m_workers(points.size());
+        std::vector<std::vector<Vector>> kept(workers);
+        m_parallel(workers, workers, [&](size_t t) {
+            for(size_t i = points.size() * t / workers; i < points.size() * (t + 1) / workers; ++i) {
+                bool inside = true;
+                for(size_t d = 0; d < 8 && inside; ++d) {
+                    inside = Predicates::orient2d(octagon[d], octagon[(d + 1) % 8], points[i]) < 0;
+                }
+                if(!inside) {
+                    kept[t].push_back(points[i]);
+                }
+            }
+        });
+        for(size_t t = 1; t < workers; ++t) {
+            kept[0].insert(kept[0].end(), kept[t].begin(), kept[t].end());
+        }
+        return std::move(kept[0]);
+    }
+
+    // Clockwise hull of n sorted points: the upper chain left to right,
+    // then the lower one back, keeping right turns only.
+    static void m_chain(const Vector* sorted, size_t n, std::vector<Vector>& hull) {
+        hull.clear();
+        for(size_t i = 0; i < n; ++i) {
+            while(hull.size() >= 2 && Predicates::orient2d(hull[hull.size() - 2], hull.back(), sorted[i]) >= 0) {
+                hull.pop_back();
+            }
+            hull.push_back(sorted[i]);
+        }
+        size_t upper = hull.size();
+        for(size_t i = n - 1; i-- > 0;) {
+            while(hull.size() > upper && Predicates::orient2d(hull[hull.size() - 2], hull.back(), sorted[i]) >= 0) {
+                hull.pop_back();
+            }
+            hull.push_back(sorted[i]);
+        }
+        if(hull.size() > 1) {
+            hull.pop_back();
+        }
+        if(hull.size() == 2 && hull[0] == hull[1]) {
+            hull.pop_back();
+        }
+    }
+
+    // Hulls of consecutive groups of m points, one after another in hulls,
+    // the g-th from offsets[g] to offsets[g + 1]. Every thread collects the
+    // hulls of its groups apart: with inexact predicates a hull may keep
+    // more points than its group has, so they are not written in place.
+    void m_groupHulls(const std::vector<Vector>& points, size_t m, std::vector<Vector>& hulls,
+                      std::vector<size_t>& offsets) const {
+        size_t groups = (points.size() + m - 1) / m;
+        offsets.assign(groups + 1, 0);
+        size_t workers = m_workers(points.size());
+        std::vector<std::vector<Vector>> parts(workers);
+        m_parallel(workers, workers, [&](size_t t) {
+            std::vector<Vector> group, hull;
+            for(size_t g = groups * t / workers; g < groups * (t + 1) / workers; ++g) {
+                size_t begin = g * m, end = std::min(begin + m, points.size());
+                group.assign(points.begin() + begin, points.begin() + end);
+                std::sort(group.begin(), group.end(), m_less);
+                m_chain(group.data(), group.size(), hull);
+                parts[t].insert(parts[t].end(), hull.begin(), hull.end());
+                offsets[g + 1] = hull.size();
+            }
+        });
+        hulls.clear();
+        for(auto& part: parts) {
+            hulls.insert(hulls.end(), part.begin(), part.end());
+        }
+        for(size_t g = 0; g < groups; ++g) {
+            offsets[g + 1] += offsets[g];
+        }
+    }
+
+    // Whether c should replace best as the next vertex after p: it is to
+    // the left of p -> best, or on that ray and farther.
+    static bool m_better(const Vector& p, const Vector& best, const Vector& c) {
+        int turn = Predicates::orient2d(p, best, c);
+        return turn > 0 || (turn == 0 && (c - p).dot(c - p) > (best - p).dot(best - p));
+    }
+
+    // Jarvis's march over the group hulls from start, fails after m steps.
+    bool m_march(const Vector& start, const std::vector<Vector>& hulls, const std::vector<size_t>& offsets,
+                 size_t m, std::vector<Vector>& march) const {
+        march.clear();
+        Vector p = start;
+        // Where p was taken from; in its own group the next vertex follows it.
+        size_t group = offsets.size(), index = 0;
+        for(size_t step = 0; step < m; ++step) {
+            march.push_back(p);
+            bool found = false;
+            Vector best;
+            size_t bestGroup = 0, bestIndex = 0;
+            for(size_t g = 0; g + 1 < offsets.size(); ++g) {
+                const Vector* hull = hulls.data() + offsets[g];
+                size_t size = offsets[g + 1] - offsets[g];
+                if(size == 0) {
+                    continue;
+                }
+                size_t i = (g == group) ? ((index + 1 == size) ? 0 : index + 1) : m_tangent(p, hull, size);
+                if(hull[i] != p && (!found || m_better(p, best, hull[i]))) {
+                    best = hull[i];
+                    bestGroup = g;
+                    bestIndex = i;
+                    found = true;
+                }
+            }
+            if(!found || best == start) {
+                return true;
+            }
+            p = best;
+            group = bestGroup;
+            index = bestIndex;
+        }
+        return false;
+    }
+
+    // Vertex q of a clockwise hull with every vertex to the right of
+    // p -> q or on it, the farthest one on it. Along the hull the edges
+    // turn left as seen from p on one arc and right on the other, q is
+    // where the left arc ends; a binary search finds it, and degenerate
+    // positions of p fall back to a scan.
+    static size_t m_tangent(const Vector& p, const Vector* hull, size_t size) {
+        if(size >= kMinSearch) {
+            size_t q = m_search(p, hull, size);
+            size_t previous = (q == 0) ? size - 1 : q - 1, next = (q + 1 == size) ? 0 : q + 1;
+            if(hull[q] != p && Predicates::orient2d(p, hull[q], hull[previous]) <= 0 &&
+               Predicates::orient2d(p, hull[q], hull[next]) <= 0) {
+                if(m_better(p, hull[q], hull[next])) {
+                    q = next;
+                }
+                else if(m_better(p, hull[q], hull[previous])) {
+                    q = previous;
+                }
+                return q;
+            }
+        }
+        size_t q = 0;
+        for(size_t i = 1; i < size; ++i) {
+            if(hull[q] == p || (hull[i] != p && m_better(p, hull[q], hull[i]))) {
+                q = i;
+            }
+        }
+        return q;
+    }
+
+    static size_t m_search(const Vector& p, const Vector* hull, size_t size) {
+        auto leftTurn = [&](size_t i) {
+            return Predicates::orient2d(p, hull[i], hull[(i + 1 == size) ? 0 : i + 1]) > 0;
+        };
+        bool firstLeft = leftTurn(0);
+        if(!firstLeft && leftTurn(size - 1)) {
+            return 0;
+        }
+        // The first index past the left arc that holds q.
+        auto past = [&](size_t i) {
+            bool left = leftTurn(i);
+            int side = Predicates::orient2d(p, hull[0], hull[i]);
+            return firstLeft ? (!left || side <= 0) : (!left && side >= 0);
+        };
+        size_t low = 1, high = size - 1;
+        while(low < high) {
+            size_t middle = (low + high) / 2;
+            if(past(middle)) {
+                high = middle;
+            }
+            else {
+                low = middle + 1;
+            }
+        }
+        return low;
+    }
+};
 
 
 int main() {
@@ -166,10 +1110,7 @@ int main() {
         b.addPoint(temp);
     }
 
-    b = -b;
-    Polygon res = a + b;
-
-    if(res.contain(Vector(0, 0))) {
+    if(Polygon::intersect(a, b)) {
         std::cout << "Yes" << std::endl;
     }
     else {
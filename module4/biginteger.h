@@ -6,6 +6,12 @@
 #define BIGINTEGER_BIGINTEGER_H
 
 #include <vector>
+#include <deque>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <charconv>
+#include <stdexcept>
 
 class BigInteger{
 public:
@@ -17,6 +23,8 @@ public:
     BigInteger& operator=(BigInteger&& bigInt) noexcept;
 
     BigInteger(const long long& number);
+    // Decimal digits after an optional minus; an empty string and a lone
+    // minus are zero, anything else throws std::invalid_argument.
     explicit BigInteger(const std::string& str);
 
     friend BigInteger operator+(const BigInteger& a, const BigInteger& b);
@@ -47,22 +55,103 @@ public:
     friend std::ostream& operator<<(std::ostream& output, const BigInteger& a);
     friend std::istream& operator>>(std::istream& input, BigInteger& a);
     std::string toString() const;
+    // Writes the decimal representation to [first, last) like std::to_chars:
+    // returns the end of it, or last with std::errc::value_too_large when it
+    // does not fit. Nothing is allocated for numbers of up to
+    // kDecimalThreshold limbs.
+    std::to_chars_result toChars(char* first, char* last) const;
 
     explicit operator bool() const;
 
-    long long operator[](size_t it) const;
+    // Limb of the absolute value in base 2^64, least significant first, 0
+    // past the end; size() is the number of limbs. This differs from the
+    // former base 10^6 digits returned as long long: a limb does not fit
+    // in long long, and decimal digits come from toString() or toChars().
+    uint64_t operator[](size_t it) const;
     size_t size() const;
 
     BigInteger abs() const;
 
 private:
-    std::vector<long long> data;
-    const static long long kFactor = 1'000'000;
-    const static long long kLogFactor = 6;
+    // Absolute value in base 2^64 without leading zero limbs; zero is a
+    // single zero limb and is never negative.
+    std::vector<uint64_t> data;
     bool isNegative = false;
 
+    // Decimal strings are converted by chunks of kDecimalDigits digits.
+    // Numbers of up to kDecimalThreshold limbs are converted chunk by chunk,
+    // longer ones are split in halves by kDecimalFactor^(2^level).
+    static constexpr uint64_t kDecimalFactor = 10'000'000'000'000'000'000ull;
+    static constexpr size_t kDecimalDigits = 19;
+    static constexpr size_t kDecimalThreshold = 32;
+    // Reciprocals of numbers up to that many limbs are found by long division.
+    static constexpr size_t kReciprocalThreshold = 64;
+    // Divisors and quotients at least that long, in limbs, are divided by
+    // the divisor's reciprocal, shorter ones by Knuth's Algorithm D.
+    static constexpr size_t kNewtonThreshold = 512;
+    static_assert(kReciprocalThreshold < kNewtonThreshold, "reciprocals start from long division");
+
+    struct DecimalPower;
+
+    // Operands shorter than that, in limbs, are multiplied by the schoolbook
+    // method, longer by Karatsuba's; Toom-3 takes over for longer ones.
+    static constexpr size_t kKaratsubaThreshold = 32;
+    static constexpr size_t kToomThreshold = 4096;
+    // From that length on the product is a convolution by number theoretic
+    // transforms modulo three primes, restored by the Chinese remainder
+    // theorem. The limbs are cut into chunks of kNttBits bits. The primes
+    // allow transforms up to kNttMaxLength, so a coefficient sums at most
+    // 2^24 products below 2^60, which is less than the product of the primes:
+    // no convolution sum wraps and the result is exact.
+    static constexpr size_t kNttThreshold = 20000;
+    static constexpr size_t kNttMaxLength = size_t(1) << 25;
+    static constexpr size_t kNttBits = 30;
+    static constexpr uint32_t kNttPrimes[3] = {167772161, 469762049, 2013265921};
+    static constexpr uint32_t kNttRoots[3] = {3, 3, 31};
+
     void m_deleteZeros();
-    void m_toNormal();
+    void m_multiplyAdd(uint64_t factor, uint64_t addend);
+    uint64_t m_divide(uint64_t divisor);
+
+    static BigInteger m_parse(const char* digits, size_t length);
+    static char* m_write(const BigInteger& x, char* first, char* last, size_t width);
+    static DecimalPower& m_decimalPower(size_t level);
+    static BigInteger m_reciprocal(const BigInteger& p);
+    static void m_divideByReciprocal(const BigInteger& x, const BigInteger& p, const BigInteger& reciprocal,
+                                     BigInteger& quotient, BigInteger& remainder);
+    static void m_divideModulo(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder);
+    static void m_newtonDivide(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder);
+    static void m_knuth(const uint64_t* u, size_t m, const uint64_t* v, size_t n, uint64_t* quotient,
+                        uint64_t* remainder);
+
+    static BigInteger m_sum(const BigInteger& a, const BigInteger& b, bool negateB);
+    static int m_compare(const BigInteger& a, const BigInteger& b);
+    static uint64_t m_addTo(uint64_t* x, size_t n, const uint64_t* y, size_t m);
+    static uint64_t m_subtractFrom(uint64_t* x, size_t n, const uint64_t* y, size_t m);
+
+    static BigInteger m_multiply(const BigInteger& a, const BigInteger& b);
+    static BigInteger m_toom3(const BigInteger& a, const BigInteger& b);
+    static BigInteger m_nttMultiply(const BigInteger& a, const BigInteger& b);
+    static size_t m_chunks(size_t limbs);
+    uint64_t m_chunk(size_t i) const;
+    template<size_t Prime>
+    static void m_convolution(const BigInteger& a, const BigInteger& b, size_t length, std::vector<uint32_t>& result);
+    template<size_t Prime>
+    static void m_ntt(std::vector<uint32_t>& a, bool inverse);
+    template<size_t Prime>
+    static uint32_t m_reduce(uint64_t x);
+    static uint32_t m_power(uint64_t base, uint64_t exponent, uint32_t mod);
+    BigInteger m_slice(size_t begin, size_t end) const;
+    BigInteger& m_shift(size_t limbs);
+    static void m_multiply(const uint64_t* a, size_t n, const uint64_t* b, size_t m, uint64_t* out);
+    static void m_schoolbook(const uint64_t* a, size_t n, const uint64_t* b, size_t m, uint64_t* out);
+    static void m_karatsuba(const uint64_t* a, const uint64_t* b, size_t n, uint64_t* out, uint64_t* scratch);
+};
+
+// kDecimalFactor^(2^level), and its reciprocal once it has been needed.
+struct BigInteger::DecimalPower {
+    BigInteger power;
+    BigInteger reciprocal;
 };
 
 
@@ -83,209 +172,73 @@ BigInteger& BigInteger::operator=(BigInteger&& bigInt) noexcept {
 }
 
 BigInteger::BigInteger(const long long& number) {
-    data.push_back(number);
-    m_toNormal();
+    isNegative = (number < 0);
+    data.push_back(isNegative ? 0 - static_cast<uint64_t>(number) : static_cast<uint64_t>(number));
 }
 
 BigInteger::BigInteger(const std::string& str) {
-    if(str.empty()) {
-        data.push_back(0);
-    }
-    else if((str.size() == 1) && (str[0] == '-')) {
-        data.push_back(0);
-    }
-    else {
-        long long beginPosition = 0;
-        if (str[0] == '-') {
-            isNegative = true;
-            beginPosition = 1;
-        }
-
-        for (ssize_t i = str.size(); (i - kLogFactor) >= beginPosition; i -= kLogFactor) {
-            std::string temp;
-            for (short j = kLogFactor; j > 0; --j) {
-                temp += str[i - j];
-            }
-            data.push_back(std::stoll(temp));
-        }
-
-        if ((str.size() - beginPosition) % kLogFactor != 0) {
-            std::string temp;
-            for (size_t j = 0; j < (str.size() - beginPosition) % kLogFactor; ++j) {
-                temp += str[j + beginPosition];
-            }
-            data.push_back(std::stoll(temp));
+    size_t beginPosition = (!str.empty() && (str[0] == '-')) ? 1 : 0;
+    for(size_t i = beginPosition; i < str.size(); ++i) {
+        if((str[i] < '0') || (str[i] > '9')) {
+            throw std::invalid_argument("BigInteger: not a decimal number: " + str);
         }
-
-        m_toNormal();
     }
+    *this = m_parse(str.data() + beginPosition, str.size() - beginPosition);
+    isNegative = (beginPosition == 1) && *this;
 }
 
 BigInteger operator+(const BigInteger& a, const BigInteger& b) {
-    bool aBigger = a.size() > b.size();
-    BigInteger c;
-    c.data.assign(aBigger ? a.size() : b.size(), 0);
-    for(size_t i = 0; i < (aBigger ? a.size() : b.size()); ++i) {
-        c.data[i] = a[i] * (a.isNegative ? -1 : 1) + b[i] * (b.isNegative ? -1 : 1);
-    }
-    c.m_toNormal();
-    return c;
+    return BigInteger::m_sum(a, b, false);
 }
 
 BigInteger operator-(const BigInteger& a, const BigInteger& b) {
-    bool aBigger = a.size() > b.size();
-    BigInteger c;
-    c.data.assign(aBigger ? a.size() : b.size(), 0);
-    for(size_t i = 0; i < (aBigger ? a.size() : b.size()); ++i) {
-        c.data[i] = a[i] * (a.isNegative ? -1 : 1) - b[i] * (b.isNegative ? -1 : 1);
-    }
-    c.m_toNormal();
-    return c;
+    return BigInteger::m_sum(a, b, true);
 }
 
 BigInteger operator*(const BigInteger& a, const BigInteger& b) {
-    size_t maxSize = a.size() > b.size() ? a.size() : b.size();
-    BigInteger c;
-    if(maxSize == 1) {
-        c.data[0] = a[0] * b[0];
-    }
-    else if(b.size() == 1) {
-        c = a;
-        for(auto& d: c.data) {
-            d *= b[0];
-        }
-    }
-    else if(a.size() == 1) {
-        c = b;
-        for(auto& d: c.data) {
-            d *= a[0];
-        }
-    }
-    else {
-        c.data.assign(a.size() + b.size() + 1, 0);
-        for(size_t i = 0; i < a.size(); ++i) {
-            for(size_t j = 0; j < b.size(); ++j) {
-                c.data[i + j + 1] += (a[i] * b[j] + c.data[i + j]) / BigInteger::kFactor;
-                c.data[i + j] = (a[i] * b[j] + c.data[i + j]) % BigInteger::kFactor;
-            }
-            for(size_t j = i + b.size(); j < a.size() + b.size(); ++j) {
-                c.data[j + 1] += c.data[j] / BigInteger::kFactor;
-                c.data[j] = c.data[j] % BigInteger::kFactor;
-            }
-        }
-    }
-
-    c.isNegative = (a.isNegative != b.isNegative);
-    c.m_toNormal();
-
+    BigInteger c = BigInteger::m_multiply(a, b);
+    c.isNegative = (a.isNegative != b.isNegative) && c;
     return c;
 }
 
 BigInteger operator/(const BigInteger& a, const BigInteger& b) {
-    BigInteger c;
-    if(a.size() < b.size()) {
-        return c;
-    }
-
-    if(a.size() == 1) {
-        c.data[0] = a[0] / b[0];
-    }
-    else if(b.size() == 1) {
-        c.data.assign(a.size(), 0);
-        long long r = 0;
-        for(size_t i = a.size(); i > 0; --i) {
-            long long temp = (a[i - 1] + r * BigInteger::kFactor) / b[0];
-            r = (a[i - 1] + r * BigInteger::kFactor) % b[0];
-            c.data[i - 1] = temp;
-        }
-    }
-    else {
-        BigInteger b_hat = b.abs();
-        BigInteger simA;
-        simA.data.clear();
-        c.data.assign(a.size(), 0);
-        for(size_t i = a.size(); i  > 0; --i) {
-            simA.data.insert(simA.data.begin(), a[i - 1]);
-
-            if(simA >= b_hat) {
-                long long q_hat = 0, left = 0, right = BigInteger::kFactor;
-                while(left <= right) {
-                    long long m = (left + right) / 2;
-                    BigInteger temp = b_hat * m;
-                    if(temp <= simA) {
-                        q_hat = m;
-                        left = m + 1;
-                    }
-                    else {
-                        right = m - 1;
-                    }
-                }
-                c.data[i - 1] = q_hat;
-                simA -= b_hat * q_hat;
-            }
-        }
-    }
-
-    c.isNegative = (a.isNegative != b.isNegative);
-    c.m_toNormal();
-
-    return c;
+    BigInteger quotient, remainder;
+    BigInteger::m_divideModulo(a, b, quotient, remainder);
+    quotient.isNegative = (a.isNegative != b.isNegative) && quotient;
+    return quotient;
 }
 
 BigInteger operator%(const BigInteger& a, const BigInteger& b) {
-    return a - (a / b) * b;
+    BigInteger quotient, remainder;
+    BigInteger::m_divideModulo(a, b, quotient, remainder);
+    remainder.isNegative = a.isNegative && remainder;
+    return remainder;
 }
 
 const BigInteger BigInteger::operator-() const {
     BigInteger copy = *this;
     copy.isNegative = !isNegative;
-    copy.m_toNormal();
+    copy.m_deleteZeros();
     return copy;
 }
 
 BigInteger& BigInteger::operator--() {
-    if(isNegative) {
-        data[0]++;
-    }
-    else {
-        data[0]--;
-    }
-    m_toNormal();
-    return *this;
+    return (*this -= 1);
 }
 
 const BigInteger BigInteger::operator--(int) {
     BigInteger old = *this;
-    if(isNegative) {
-        data[0]++;
-    }
-    else {
-        data[0]--;
-    }
-    m_toNormal();
+    *this -= 1;
     return old;
 }
 
 BigInteger& BigInteger::operator++() {
-    if(isNegative) {
-        data[0]--;
-    }
-    else {
-        data[0]++;
-    }
-    m_toNormal();
-    return *this;
+    return (*this += 1);
 }
 
 const BigInteger BigInteger::operator++(int) {
     BigInteger old = *this;
-    if(isNegative) {
-        data[0]--;
-    }
-    else {
-        data[0]++;
-    }
-    m_toNormal();
+    *this += 1;
     return old;
 }
 
@@ -318,19 +271,23 @@ bool operator!=(const BigInteger& a, const BigInteger& b) {
 }
 
 bool operator<(const BigInteger& a, const BigInteger& b) {
-    return (a - b).isNegative && (a != b);
+    if(a.isNegative != b.isNegative) {
+        return a.isNegative;
+    }
+    int comparison = BigInteger::m_compare(a, b);
+    return a.isNegative ? (comparison > 0) : (comparison < 0);
 }
 
 bool operator<=(const BigInteger& a, const BigInteger& b) {
-    return (a == b) || (a - b).isNegative;
+    return !(b < a);
 }
 
 bool operator>(const BigInteger& a, const BigInteger& b) {
-    return (b - a).isNegative && (a != b);
+    return b < a;
 }
 
 bool operator>=(const BigInteger& a, const BigInteger& b) {
-    return (a == b) || (b - a).isNegative;
+    return !(a < b);
 }
 
 std::ostream& operator<<(std::ostream& output, const BigInteger& a) {
@@ -346,31 +303,32 @@ std::istream& operator>>(std::istream& input, BigInteger& a) {
     return input;
 }
 
+// The buffer takes the sign and 64 log10(2) < 0.30103 * 64 digits per limb.
 std::string BigInteger::toString() const {
-    std::string res;
+    std::string res(data.size() * 64 * 30103 / 100000 + 2, '\0');
+    res.resize(toChars(&res[0], &res[0] + res.size()).ptr - res.data());
+    return res;
+}
 
+std::to_chars_result BigInteger::toChars(char* first, char* last) const {
     if(isNegative) {
-        res += '-';
-    }
-
-    for(size_t i = data.size(); i > 0; --i) {
-        std::string temp = std::to_string(data[i - 1]);
-        if(i < data.size()) {
-            while(temp.size() < kLogFactor) {
-                temp.insert(temp.begin(), '0');
-            }
+        if(first == last) {
+            return {last, std::errc::value_too_large};
         }
-        res += temp;
+        *first++ = '-';
     }
-
-    return res;
+    char* end = m_write(*this, first, last, 0);
+    if(end == nullptr) {
+        return {last, std::errc::value_too_large};
+    }
+    return {end, std::errc()};
 }
 
 BigInteger::operator bool() const {
     return !((data.size() == 1) && (data[0] == 0));
 }
 
-long long BigInteger::operator[](size_t it) const {
+uint64_t BigInteger::operator[](size_t it) const {
     if(it < data.size()) {
         return data[it];
     }
@@ -388,66 +346,669 @@ BigInteger BigInteger::abs() const {
     return a;
 }
 
-void BigInteger::m_deleteZeros() {
-    size_t it = data.size();
-    while(data[it - 1] == 0) {
-        data.pop_back();
-        --it;
-        if(it == 0) {
-            data.push_back(0);
-            isNegative = false;
-            break;
+// a + b, or a - b when negateB is set: absolute values are added when the
+// signs agree, otherwise the smaller is subtracted from the larger.
+BigInteger BigInteger::m_sum(const BigInteger& a, const BigInteger& b, bool negateB) {
+    bool bNegative = (b.isNegative != negateB);
+    BigInteger c;
+    if(a.isNegative == bNegative) {
+        const BigInteger& longer = (a.size() >= b.size()) ? a : b;
+        const BigInteger& shorter = (a.size() >= b.size()) ? b : a;
+        c.data.assign(longer.size() + 1, 0);
+        std::copy(longer.data.begin(), longer.data.end(), c.data.begin());
+        m_addTo(c.data.data(), c.size(), shorter.data.data(), shorter.size());
+        c.isNegative = a.isNegative;
+    }
+    else {
+        bool aBigger = (m_compare(a, b) >= 0);
+        const BigInteger& larger = aBigger ? a : b;
+        const BigInteger& smaller = aBigger ? b : a;
+        c.data = larger.data;
+        m_subtractFrom(c.data.data(), c.size(), smaller.data.data(), smaller.size());
+        c.isNegative = aBigger ? a.isNegative : bNegative;
+    }
+    c.m_deleteZeros();
+    return c;
+}
+
+// Sign of |a| - |b|.
+int BigInteger::m_compare(const BigInteger& a, const BigInteger& b) {
+    if(a.size() != b.size()) {
+        return (a.size() < b.size()) ? -1 : 1;
+    }
+    for(size_t i = a.size(); i > 0; --i) {
+        if(a.data[i - 1] != b.data[i - 1]) {
+            return (a.data[i - 1] < b.data[i - 1]) ? -1 : 1;
         }
     }
+    return 0;
 }
 
-void BigInteger::m_toNormal() {
-    m_deleteZeros();
-    if(data.size() == 1) {
-        if(data[0] == 0) {
-            isNegative = false;
-            return;
+// x[0, n) += y[0, m) for m <= n, returns the carry out of x.
+uint64_t BigInteger::m_addTo(uint64_t* x, size_t n, const uint64_t* y, size_t m) {
+    uint64_t carry = 0;
+    for(size_t i = 0; i < m; ++i) {
+        unsigned __int128 current = static_cast<unsigned __int128>(x[i]) + y[i] + carry;
+        x[i] = static_cast<uint64_t>(current);
+        carry = static_cast<uint64_t>(current >> 64);
+    }
+    for(size_t i = m; (carry != 0) && (i < n); ++i) {
+        carry = (++x[i] == 0);
+    }
+    return carry;
+}
+
+// x[0, n) -= y[0, m) for m <= n, returns the borrow out of x.
+uint64_t BigInteger::m_subtractFrom(uint64_t* x, size_t n, const uint64_t* y, size_t m) {
+    uint64_t borrow = 0;
+    for(size_t i = 0; i < m; ++i) {
+        unsigned __int128 current = static_cast<unsigned __int128>(x[i]) - y[i] - borrow;
+        x[i] = static_cast<uint64_t>(current);
+        borrow = static_cast<uint64_t>(current >> 127);
+    }
+    for(size_t i = m; (borrow != 0) && (i < n); ++i) {
+        borrow = (x[i]-- == 0);
+    }
+    return borrow;
+}
+
+// Product of the absolute values.
+BigInteger BigInteger::m_multiply(const BigInteger& a, const BigInteger& b) {
+    size_t n = a.size(), m = b.size();
+    if(std::min(n, m) >= kNttThreshold && m_chunks(n) + m_chunks(m) <= kNttMaxLength) {
+        return m_nttMultiply(a, b);
+    }
+    if(std::min(n, m) >= kToomThreshold && 3 * std::min(n, m) > 2 * std::max(n, m)) {
+        return m_toom3(a, b);
+    }
+    BigInteger c;
+    c.data.assign(n + m, 0);
+    m_multiply(a.data.data(), n, b.data.data(), m, c.data.data());
+    c.m_deleteZeros();
+    return c;
+}
+
+// Toom-3 on absolute values: both are split into three parts of k limbs,
+// the part polynomials are multiplied at 0, 1, -1, -2 and infinity, and
+// the product is interpolated back by Bodrato's sequence.
+BigInteger BigInteger::m_toom3(const BigInteger& a, const BigInteger& b) {
+    size_t k = (std::max(a.size(), b.size()) + 2) / 3;
+    BigInteger a0 = a.m_slice(0, k), a1 = a.m_slice(k, 2 * k), a2 = a.m_slice(2 * k, 3 * k);
+    BigInteger b0 = b.m_slice(0, k), b1 = b.m_slice(k, 2 * k), b2 = b.m_slice(2 * k, 3 * k);
+
+    auto product = [](const BigInteger& x, const BigInteger& y) {
+        BigInteger z = m_multiply(x, y);
+        z.isNegative = (x.isNegative != y.isNegative) && z;
+        return z;
+    };
+    BigInteger aSum = a0 + a2, bSum = b0 + b2;
+    BigInteger aMinusOne = aSum - a1, bMinusOne = bSum - b1;
+    BigInteger r0 = product(a0, b0);
+    BigInteger r1 = product(aSum + a1, bSum + b1);
+    BigInteger rMinusOne = product(aMinusOne, bMinusOne);
+    BigInteger rMinusTwo = product((aMinusOne + a2) * 2 - a0, (bMinusOne + b2) * 2 - b0);
+    BigInteger rInfinity = product(a2, b2);
+
+    BigInteger r3 = (rMinusTwo - r1) / 3;
+    r1 = (r1 - rMinusOne) / 2;
+    BigInteger r2 = rMinusOne - r0;
+    r3 = (r2 - r3) / 2 + rInfinity * 2;
+    r2 = r2 + r1 - rInfinity;
+    r1 = r1 - r3;
+
+    return r0 + r1.m_shift(k) + r2.m_shift(2 * k) + r3.m_shift(3 * k) + rInfinity.m_shift(4 * k);
+}
+
+// Product of the absolute values by the convolution modulo each prime,
+// combined by Garner's method: x = x0 + p0 (x1 + p1 x2) with xi < pi.
+// Coefficients with their carries are written back as chunks.
+BigInteger BigInteger::m_nttMultiply(const BigInteger& a, const BigInteger& b) {
+    size_t chunks = m_chunks(a.size()) + m_chunks(b.size());
+    size_t length = 1;
+    while(length < chunks) {
+        length <<= 1;
+    }
+    std::vector<uint32_t> r0, r1, r2;
+    m_convolution<0>(a, b, length, r0);
+    m_convolution<1>(a, b, length, r1);
+    m_convolution<2>(a, b, length, r2);
+
+    const uint64_t p0 = kNttPrimes[0], p1 = kNttPrimes[1], p2 = kNttPrimes[2];
+    const uint64_t p0Inverse1 = m_power(p0, p1 - 2, p1);
+    const uint64_t p0p1Inverse2 = m_power(p0 * p1 % p2, p2 - 2, p2);
+    const unsigned __int128 p0p1 = p0 * p1;
+    const uint64_t mask = (uint64_t(1) << kNttBits) - 1;
+
+    BigInteger c;
+    c.data.assign(a.size() + b.size(), 0);
+    unsigned __int128 carry = 0;
+    for(size_t i = 0; i < chunks; ++i) {
+        uint64_t x0 = r0[i];
+        uint64_t x1 = (r1[i] + p1 - x0 % p1) % p1 * p0Inverse1 % p1;
+        uint64_t x2 = (r2[i] + p2 - (x0 + p0 * x1) % p2) % p2 * p0p1Inverse2 % p2;
+        carry += x0 + p0 * x1 + p0p1 * x2;
+        uint64_t chunk = static_cast<uint64_t>(carry) & mask;
+        carry >>= kNttBits;
+
+        size_t bit = i * kNttBits, limb = bit / 64, offset = bit % 64;
+        if(limb < c.size()) {
+            c.data[limb] |= chunk << offset;
+        }
+        if((offset + kNttBits > 64) && (limb + 1 < c.size())) {
+            c.data[limb + 1] |= chunk >> (64 - offset);
+        }
+    }
+    c.m_deleteZeros();
+    return c;
+}
+
+// Number of chunks of kNttBits bits in that many limbs.
+size_t BigInteger::m_chunks(size_t limbs) {
+    return (64 * limbs + kNttBits - 1) / kNttBits;
+}
+
+// Bits [i * kNttBits, (i + 1) * kNttBits) of the absolute value.
+uint64_t BigInteger::m_chunk(size_t i) const {
+    size_t bit = i * kNttBits, limb = bit / 64, offset = bit % 64;
+    uint64_t chunk = (limb < data.size()) ? data[limb] >> offset : 0;
+    if((offset + kNttBits > 64) && (limb + 1 < data.size())) {
+        chunk |= data[limb + 1] << (64 - offset);
+    }
+    return chunk & ((uint64_t(1) << kNttBits) - 1);
+}
+
+// Cyclic convolution of the chunks modulo kNttPrimes[Prime], a square
+// needs one forward transform. Pointwise products are Montgomery reduced,
+// the extra 2^-32 factor is taken back in the inverse transform.
+template<size_t Prime>
+void BigInteger::m_convolution(const BigInteger& a, const BigInteger& b, size_t length, std::vector<uint32_t>& result) {
+    constexpr uint32_t mod = kNttPrimes[Prime];
+    result.assign(length, 0);
+    for(size_t i = 0; i < m_chunks(a.size()); ++i) {
+        result[i] = a.m_chunk(i) % mod;
+    }
+    m_ntt<Prime>(result, false);
+    if(&a == &b) {
+        for(auto& x: result) {
+            x = m_reduce<Prime>(uint64_t(x) * x);
+        }
+    }
+    else {
+        std::vector<uint32_t> other(length, 0);
+        for(size_t i = 0; i < m_chunks(b.size()); ++i) {
+            other[i] = b.m_chunk(i) % mod;
+        }
+        m_ntt<Prime>(other, false);
+        for(size_t i = 0; i < length; ++i) {
+            result[i] = m_reduce<Prime>(uint64_t(result[i]) * other[i]);
         }
     }
+    m_ntt<Prime>(result, true);
+}
+
+// Iterative radix-2 transform of a power of two length, in place. Roots
+// are kept multiplied by 2^32, so a Montgomery reduction of the product
+// with a root is the plain product modulo the prime. The inverse
+// transform also multiplies by 2^32 along with the division by length.
+template<size_t Prime>
+void BigInteger::m_ntt(std::vector<uint32_t>& a, bool inverse) {
+    constexpr uint64_t mod = kNttPrimes[Prime];
+    constexpr uint64_t montgomery = (uint64_t(1) << 32) % mod;
+    size_t n = a.size();
+    for(size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for(; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if(i < j) {
+            std::swap(a[i], a[j]);
+        }
+    }
+
+    std::vector<uint32_t> roots(std::max<size_t>(1, n / 2));
+    for(size_t length = 2; length <= n; length <<= 1) {
+        size_t half = length / 2;
+        uint64_t step = m_power(kNttRoots[Prime], (mod - 1) / length, mod);
+        if(inverse) {
+            step = m_power(step, mod - 2, mod);
+        }
+        step = step * montgomery % mod;
+        roots[0] = montgomery;
+        for(size_t k = 1; k < half; ++k) {
+            roots[k] = m_reduce<Prime>(uint64_t(roots[k - 1]) * step);
+        }
+        for(size_t i = 0; i < n; i += length) {
+            uint32_t* low = a.data() + i;
+            uint32_t* high = low + half;
+            for(size_t k = 0; k < half; ++k) {
+                uint32_t u = low[k];
+                uint32_t v = m_reduce<Prime>(uint64_t(high[k]) * roots[k]);
+                low[k] = (u + v >= mod) ? u + v - mod : u + v;
+                high[k] = (u >= v) ? u - v : u + mod - v;
+            }
+        }
+    }
+
+    if(inverse) {
+        uint64_t scale = m_power(n, mod - 2, mod) * montgomery % mod * montgomery % mod;
+        for(auto& x: a) {
+            x = m_reduce<Prime>(x * scale);
+        }
+    }
+}
 
-    // Prepare data to check sign
-    for(size_t i = 0; i < data.size() - 1; ++i) {
-        if(data[i] >= kFactor) {
-            data[i + 1] += data[i] / kFactor;
-            data[i] %= kFactor;
+// x * 2^-32 modulo kNttPrimes[Prime] for x < 2^32 * kNttPrimes[Prime].
+template<size_t Prime>
+uint32_t BigInteger::m_reduce(uint64_t x) {
+    constexpr uint32_t mod = kNttPrimes[Prime];
+    constexpr uint32_t inverse = [] {
+        uint32_t result = mod;
+        for(int i = 0; i < 4; ++i) {
+            result *= 2 - mod * result;
         }
-        else if(data[i] < 0) {
-            --data[i + 1];
-            data[i] += kFactor;
+        return result;
+    }();
+    // The primes are below 2^31, so the sum fits and the result is below 2 mod.
+    uint32_t q = static_cast<uint32_t>(x) * (0 - inverse);
+    uint32_t result = static_cast<uint32_t>((x + uint64_t(q) * mod) >> 32);
+    return (result >= mod) ? result - mod : result;
+}
+
+uint32_t BigInteger::m_power(uint64_t base, uint64_t exponent, uint32_t mod) {
+    uint64_t result = 1;
+    base %= mod;
+    for(; exponent > 0; exponent >>= 1) {
+        if(exponent & 1) {
+            result = result * base % mod;
         }
+        base = base * base % mod;
+    }
+    return result;
+}
+
+// Limbs from begin to end, as a non-negative number.
+BigInteger BigInteger::m_slice(size_t begin, size_t end) const {
+    BigInteger c;
+    if(begin < data.size()) {
+        c.data.assign(data.begin() + begin, data.begin() + std::min(end, data.size()));
+        c.m_deleteZeros();
+    }
+    return c;
+}
+
+// Multiplies by 2^(64 limbs).
+BigInteger& BigInteger::m_shift(size_t limbs) {
+    if(*this) {
+        data.insert(data.begin(), limbs, 0);
+    }
+    return *this;
+}
+
+// out[0, n + m) = a * b for normalized limbs, out must not overlap them.
+void BigInteger::m_multiply(const uint64_t* a, size_t n, const uint64_t* b, size_t m, uint64_t* out) {
+    if(n < m) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    if(m < kKaratsubaThreshold) {
+        m_schoolbook(a, n, b, m, out);
+        return;
+    }
+
+    // Pieces of a as long as b, each by Karatsuba.
+    std::vector<uint64_t> scratch(8 * m + 64), piece(2 * m);
+    std::fill(out, out + n + m, 0);
+    for(size_t begin = 0; begin < n; begin += m) {
+        size_t length = std::min(m, n - begin);
+        if(length == m) {
+            m_karatsuba(a + begin, b, m, piece.data(), scratch.data());
+        }
+        else {
+            m_multiply(a + begin, length, b, m, piece.data());
+        }
+        m_addTo(out + begin, n + m - begin, piece.data(), length + m);
+    }
+}
+
+// Row by row, a row is a multiply-accumulate of a by one limb of b.
+void BigInteger::m_schoolbook(const uint64_t* a, size_t n, const uint64_t* b, size_t m, uint64_t* out) {
+    std::fill(out, out + n, 0);
+    for(size_t j = 0; j < m; ++j) {
+        uint64_t carry = 0;
+        for(size_t i = 0; i < n; ++i) {
+            unsigned __int128 current = static_cast<unsigned __int128>(a[i]) * b[j] + out[i + j] + carry;
+            out[i + j] = static_cast<uint64_t>(current);
+            carry = static_cast<uint64_t>(current >> 64);
+        }
+        out[n + j] = carry;
+    }
+}
+
+// out[0, 2n) = a * b for n limbs each: with a = a1 B^h + a0 and the same
+// for b, a * b = z2 B^2h + (z1 - z2 - z0) B^h + z0 where z0 = a0 b0,
+// z2 = a1 b1 and z1 = (a0 + a1)(b0 + b1). scratch holds 8n + 64 limbs.
+void BigInteger::m_karatsuba(const uint64_t* a, const uint64_t* b, size_t n, uint64_t* out, uint64_t* scratch) {
+    if(n < kKaratsubaThreshold) {
+        m_schoolbook(a, n, b, n, out);
+        return;
+    }
+    size_t low = n / 2, high = n - low;
+    m_karatsuba(a, b, low, out, scratch);
+    m_karatsuba(a + low, b + low, high, out + 2 * low, scratch);
+
+    uint64_t* aSum = scratch;
+    uint64_t* bSum = aSum + high + 1;
+    uint64_t* middle = bSum + high + 1;
+    auto add = [&](const uint64_t* x, uint64_t* sum) {
+        std::copy(x + low, x + n, sum);
+        sum[high] = m_addTo(sum, high, x, low);
+    };
+    add(a, aSum);
+    add(b, bSum);
+    m_karatsuba(aSum, bSum, high + 1, middle, middle + 2 * (high + 1));
+
+    // middle -= z0 + z2, then out += middle B^low; the top limbs of middle
+    // past the end of out are zero.
+    m_subtractFrom(middle, 2 * (high + 1), out, 2 * low);
+    m_subtractFrom(middle, 2 * (high + 1), out + 2 * low, 2 * high);
+    m_addTo(out + low, 2 * n - low, middle, std::min(2 * (high + 1), 2 * n - low));
+}
+
+void BigInteger::m_deleteZeros() {
+    while((data.size() > 1) && (data.back() == 0)) {
+        data.pop_back();
+    }
+    if(data.empty()) {
+        data.push_back(0);
+    }
+    if((data.size() == 1) && (data[0] == 0)) {
+        isNegative = false;
+    }
+}
+
+// Absolute value = absolute value * factor + addend.
+void BigInteger::m_multiplyAdd(uint64_t factor, uint64_t addend) {
+    uint64_t carry = addend;
+    for(auto& limb: data) {
+        unsigned __int128 current = static_cast<unsigned __int128>(limb) * factor + carry;
+        limb = static_cast<uint64_t>(current);
+        carry = static_cast<uint64_t>(current >> 64);
     }
+    if(carry != 0) {
+        data.push_back(carry);
+    }
+    m_deleteZeros();
+}
 
-    // If sign of last 'digit' is negative, number has the opposite sign.
-    if(data.back() < 0) {
-        data.back() = -data.back();
-        if(data.size() > 1) {
-            data.back()--;
-            for(size_t i = data.size() - 1; i > 1; --i) {
-                data[i - 1] = kFactor - data[i - 1] - 1;
+// Absolute value /= divisor, returns the remainder.
+uint64_t BigInteger::m_divide(uint64_t divisor) {
+    uint64_t remainder = 0;
+    for(size_t i = data.size(); i > 0; --i) {
+        unsigned __int128 current = (static_cast<unsigned __int128>(remainder) << 64) | data[i - 1];
+        data[i - 1] = static_cast<uint64_t>(current / divisor);
+        remainder = static_cast<uint64_t>(current % divisor);
+    }
+    m_deleteZeros();
+    return remainder;
+}
+
+// Value of length decimal digits: the low part takes kDecimalDigits * 2^level
+// digits for the largest such level below length, so it is
+// high * kDecimalFactor^(2^level) + low.
+BigInteger BigInteger::m_parse(const char* digits, size_t length) {
+    if(length <= kDecimalThreshold * kDecimalDigits) {
+        BigInteger c;
+        for(size_t i = 0; i < length;) {
+            size_t end = i + (length - i - 1) % kDecimalDigits + 1;
+            uint64_t chunk = 0;
+            for(; i < end; ++i) {
+                chunk = chunk * 10 + (digits[i] - '0');
             }
-            data[0] = kFactor - data[0];
+            c.m_multiplyAdd(kDecimalFactor, chunk);
         }
-        isNegative = !isNegative;
+        return c;
     }
 
-    for(size_t i = 0; i < data.size(); ++i) {
-        if(data[i] >= kFactor) {
-            if(i + 1 >= data.size()) {
-                data.push_back(data[i] / kFactor);
+    size_t level = 0;
+    while((kDecimalDigits << (level + 1)) < length) {
+        ++level;
+    }
+    size_t lowLength = kDecimalDigits << level;
+    BigInteger high = m_parse(digits, length - lowLength);
+    return m_multiply(high, m_decimalPower(level).power) + m_parse(digits + length - lowLength, lowLength);
+}
+
+// Writes |x| to [first, last) padded with zeros to width digits, returns
+// the end or nullptr when it does not fit. Long numbers are split as
+// q * kDecimalFactor^(2^level) + r for the least level whose power squared
+// is as long as x, so r takes exactly kDecimalDigits * 2^level digits.
+char* BigInteger::m_write(const BigInteger& x, char* first, char* last, size_t width) {
+    if(x.size() <= kDecimalThreshold) {
+        uint64_t limbs[kDecimalThreshold];
+        uint64_t chunks[kDecimalThreshold + 1];
+        size_t size = x.size(), count = 0;
+        std::copy(x.data.begin(), x.data.end(), limbs);
+        // Each chunk takes at least 63 bits off, 10^19 > 2^63.
+        do {
+            uint64_t remainder = 0;
+            for(size_t i = size; i > 0; --i) {
+                unsigned __int128 current = (static_cast<unsigned __int128>(remainder) << 64) | limbs[i - 1];
+                limbs[i - 1] = static_cast<uint64_t>(current / kDecimalFactor);
+                remainder = static_cast<uint64_t>(current % kDecimalFactor);
             }
-            else {
-                data[i + 1] += data[i] / kFactor;
+            chunks[count++] = remainder;
+            while((size > 0) && (limbs[size - 1] == 0)) {
+                --size;
             }
-            data[i] %= kFactor;
+        } while(size > 0);
+
+        char top[kDecimalDigits];
+        size_t topLength = std::to_chars(top, top + kDecimalDigits, chunks[count - 1]).ptr - top;
+        size_t length = topLength + (count - 1) * kDecimalDigits;
+        size_t zeros = (width > length) ? width - length : 0;
+        if(static_cast<size_t>(last - first) < zeros + length) {
+            return nullptr;
         }
+        first = std::fill_n(first, zeros, '0');
+        first = std::copy(top, top + topLength, first);
+        for(size_t i = count - 1; i > 0; --i) {
+            uint64_t chunk = chunks[i - 1];
+            for(size_t j = kDecimalDigits; j > 0; --j) {
+                first[j - 1] = static_cast<char>('0' + chunk % 10);
+                chunk /= 10;
+            }
+            first += kDecimalDigits;
+        }
+        return first;
     }
 
-    m_deleteZeros();
+    size_t level = 0;
+    while(2 * m_decimalPower(level).power.size() < x.size()) {
+        ++level;
+    }
+    DecimalPower& divisor = m_decimalPower(level);
+    if(!divisor.reciprocal) {
+        divisor.reciprocal = m_reciprocal(divisor.power);
+    }
+    BigInteger q, r;
+    m_divideByReciprocal(x, divisor.power, divisor.reciprocal, q, r);
+
+    size_t lowWidth = kDecimalDigits << level;
+    first = m_write(q, first, last, (width > lowWidth) ? width - lowWidth : 0);
+    if(first == nullptr) {
+        return nullptr;
+    }
+    return m_write(r, first, last, lowWidth);
+}
+
+// Powers are squared from the previous level on first use and kept for
+// later conversions; a deque keeps references valid while it grows.
+BigInteger::DecimalPower& BigInteger::m_decimalPower(size_t level) {
+    thread_local std::deque<DecimalPower> powers;
+    while(powers.size() <= level) {
+        if(powers.empty()) {
+            powers.push_back({BigInteger(), BigInteger()});
+            powers.back().power.data[0] = kDecimalFactor;
+        }
+        else {
+            const BigInteger& previous = powers.back().power;
+            powers.push_back({m_multiply(previous, previous), BigInteger()});
+        }
+    }
+    return powers[level];
+}
+
+// An approximation of floor(B^2s / p) for s limbs of p and B = 2^64, not
+// above it and less by at most three. The reciprocal of the top h limbs,
+// shifted, has relative error below 5 B^(1 - h); one Newton step
+// x += x (B^2s - p x) / B^2s squares it from below, so h >= s / 2 + 2 leaves
+// less than a unit. Truncating the step adds another, which the last
+// decrement takes off.
+BigInteger BigInteger::m_reciprocal(const BigInteger& p) {
+    size_t s = p.size();
+    BigInteger power;
+    power.data.assign(2 * s + 1, 0);
+    power.data[2 * s] = 1;
+    if(s <= kReciprocalThreshold) {
+        return power / p;
+    }
+
+    size_t h = s / 2 + 2, k = s - h;
+    BigInteger x = m_reciprocal(p.m_slice(k, s)).m_shift(k);
+    BigInteger error = power - p * x;
+    BigInteger step = (x * error).m_slice(2 * s, SIZE_MAX);
+    step.isNegative = error.isNegative && step;
+    x += step;
+    return --x;
+}
+
+// Quotient and remainder of |x| by p with s limbs, for |x| below B^2s and
+// reciprocal from m_reciprocal(p). The estimate
+// floor(floor(|x| / B^(s-1)) * reciprocal / B^(s+1)) is never above the
+// quotient and at most a few less.
+void BigInteger::m_divideByReciprocal(const BigInteger& x, const BigInteger& p, const BigInteger& reciprocal,
+                                      BigInteger& quotient, BigInteger& remainder) {
+    size_t s = p.size();
+    quotient = m_multiply(x.m_slice(s - 1, SIZE_MAX), reciprocal).m_slice(s + 1, SIZE_MAX);
+    BigInteger product = m_multiply(quotient, p);
+    remainder = x.abs();
+    m_subtractFrom(remainder.data.data(), remainder.size(), product.data.data(), product.size());
+    remainder.m_deleteZeros();
+    while(m_compare(remainder, p) >= 0) {
+        m_subtractFrom(remainder.data.data(), remainder.size(), p.data.data(), p.size());
+        remainder.m_deleteZeros();
+        ++quotient;
+    }
+}
+
+// Quotient and remainder of |a| by |b|.
+void BigInteger::m_divideModulo(const BigInteger& a, const BigInteger& b, BigInteger& quotient,
+                                BigInteger& remainder) {
+    size_t m = a.size(), n = b.size();
+    if(m_compare(a, b) < 0) {
+        quotient = BigInteger();
+        remainder = a.abs();
+    }
+    else if(n == 1) {
+        quotient = a.abs();
+        remainder = BigInteger(0);
+        remainder.data[0] = quotient.m_divide(b.data[0]);
+    }
+    else if((n >= kNewtonThreshold) && (m - n >= kNewtonThreshold)) {
+        m_newtonDivide(a, b, quotient, remainder);
+    }
+    else {
+        quotient.data.assign(m - n + 1, 0);
+        remainder.data.assign(n, 0);
+        m_knuth(a.data.data(), m, b.data.data(), n, quotient.data.data(), remainder.data.data());
+        quotient.isNegative = remainder.isNegative = false;
+        quotient.m_deleteZeros();
+        remainder.m_deleteZeros();
+    }
+}
+
+// |a| is cut into blocks of s limbs, s the length of b, and divided from
+// the top: the remainder so far followed by the next block is below b B^s,
+// so each block takes one division by the reciprocal of b.
+void BigInteger::m_newtonDivide(const BigInteger& a, const BigInteger& b, BigInteger& quotient,
+                                BigInteger& remainder) {
+    size_t s = b.size();
+    BigInteger divisor = b.abs();
+    BigInteger reciprocal = m_reciprocal(divisor);
+    quotient.data.assign(a.size(), 0);
+    quotient.isNegative = false;
+    remainder = BigInteger();
+    BigInteger x, q;
+    for(size_t begin = (a.size() - 1) / s * s + s; begin > 0; begin -= s) {
+        x.data.assign(a.data.begin() + begin - s, a.data.begin() + std::min(begin, a.size()));
+        if(remainder) {
+            x.data.resize(s, 0);
+            x.data.insert(x.data.end(), remainder.data.begin(), remainder.data.end());
+        }
+        x.m_deleteZeros();
+        m_divideByReciprocal(x, divisor, reciprocal, q, remainder);
+        std::copy(q.data.begin(), q.data.end(), quotient.data.begin() + begin - s);
+    }
+    quotient.m_deleteZeros();
+}
+
+// Knuth's Algorithm D: quotient[0, m - n + 1) and remainder[0, n) of
+// u[0, m) by v[0, n) for n >= 2 and v[n - 1] != 0. Both are shifted so the
+// top bit of v is set; then the quotient limb estimated from the top two
+// limbs of u and the top one of v, corrected by the second one of v, is at
+// most one too big.
+void BigInteger::m_knuth(const uint64_t* u, size_t m, const uint64_t* v, size_t n, uint64_t* quotient,
+                         uint64_t* remainder) {
+    int shift = __builtin_clzll(v[n - 1]);
+    std::vector<uint64_t> vn(n), un(m + 1);
+    for(size_t i = n - 1; i > 0; --i) {
+        vn[i] = (v[i] << shift) | (shift ? v[i - 1] >> (64 - shift) : 0);
+    }
+    vn[0] = v[0] << shift;
+    un[m] = shift ? u[m - 1] >> (64 - shift) : 0;
+    for(size_t i = m - 1; i > 0; --i) {
+        un[i] = (u[i] << shift) | (shift ? u[i - 1] >> (64 - shift) : 0);
+    }
+    un[0] = u[0] << shift;
+
+    const unsigned __int128 base = static_cast<unsigned __int128>(1) << 64;
+    for(size_t j = m - n + 1; j > 0; --j) {
+        uint64_t* window = un.data() + j - 1;
+        unsigned __int128 numerator = (static_cast<unsigned __int128>(window[n]) << 64) | window[n - 1];
+        unsigned __int128 qHat = numerator / vn[n - 1];
+        unsigned __int128 rHat = numerator - qHat * vn[n - 1];
+        while((qHat >= base) || (qHat * vn[n - 2] > ((rHat << 64) | window[n - 2]))) {
+            --qHat;
+            rHat += vn[n - 1];
+            if(rHat >= base) {
+                break;
+            }
+        }
+
+        // window -= qHat * vn, adding vn back when that went below zero.
+        uint64_t q = static_cast<uint64_t>(qHat), carry = 0, borrow = 0;
+        for(size_t i = 0; i < n; ++i) {
+            unsigned __int128 product = static_cast<unsigned __int128>(q) * vn[i] + carry;
+            carry = static_cast<uint64_t>(product >> 64);
+            unsigned __int128 difference =
+                    static_cast<unsigned __int128>(window[i]) - static_cast<uint64_t>(product) - borrow;
+            window[i] = static_cast<uint64_t>(difference);
+            borrow = static_cast<uint64_t>(difference >> 127);
+        }
+        unsigned __int128 top = static_cast<unsigned __int128>(window[n]) - carry - borrow;
+        window[n] = static_cast<uint64_t>(top);
+        if(top >> 127) {
+            --q;
+            window[n] += m_addTo(window, n, vn.data(), n);
+        }
+        quotient[j - 1] = q;
+    }
+
+    for(size_t i = 0; i + 1 < n; ++i) {
+        remainder[i] = (un[i] >> shift) | (shift ? un[i + 1] << (64 - shift) : 0);
+    }
+    remainder[n - 1] = un[n - 1] >> shift;
 }
 
 #endif //BIGINTEGER_BIGINTEGER_H